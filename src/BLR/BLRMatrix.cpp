@@ -2157,7 +2157,25 @@ namespace strumpack {
     gemm(Trans ta, Trans tb, scalar_t alpha, const BLRMatrix<scalar_t>& A,
          const DenseMatrix<scalar_t>& B, scalar_t beta,
          DenseMatrix<scalar_t>& C, int task_depth) {
-      std::cout << "TODO gemm BLR*Dense+Dense" << std::endl;
+      using DMW_t = DenseMatrixWrapper<scalar_t>;
+      const auto imax = ta == Trans::N ? A.rowblocks() : A.colblocks();
+      const auto kmax = ta == Trans::N ? A.colblocks() : A.rowblocks();
+      // op(B) is split in row blocks matching the column blocks of
+      // op(A), so B itself is split in column blocks if tb != N
+      for (std::size_t i=0; i<imax; i++) {
+        DMW_t Ci(ta==Trans::N ? A.tilerows(i) : A.tilecols(i), C.cols(), C,
+                 ta==Trans::N ? A.tileroff(i) : A.tilecoff(i), 0);
+        for (std::size_t k=0; k<kmax; k++) {
+          auto bk = ta==Trans::N ? A.tilecols(k) : A.tilerows(k);
+          auto bo = ta==Trans::N ? A.tilecoff(k) : A.tileroff(k);
+          auto& Bnc = const_cast<DenseMatrix<scalar_t>&>(B);
+          DMW_t Bk = tb==Trans::N ?
+            DMW_t(bk, B.cols(), Bnc, bo, 0) :
+            DMW_t(B.rows(), bk, Bnc, 0, bo);
+          gemm(ta, tb, alpha, ta==Trans::N ? A.tile(i, k) : A.tile(k, i),
+               Bk, k==0 ? beta : scalar_t(1.), Ci, task_depth);
+        }
+      }
     }
 
 
@@ -78,7 +78,7 @@ namespace strumpack {
       public WorkCompressBase<scalar_t>  {
     public:
       std::vector<WorkCompress<scalar_t>> c;
-      // only needed in the new compression algorithm
+      // only needed in the stable and incremental compression algorithms
       DenseMatrix<scalar_t> Qr, Qc;
       void split(const std::pair<std::size_t,std::size_t>& dim) {
         if (c.empty()) {
@@ -67,7 +67,9 @@ namespace strumpack {
         Amult(Rr_new, Rc_new, Sr_new, Sc_new);
         if (opts.verbose())
           std::cout << "# compressing with d = " << d-opts.p()
-                    << " + " << opts.p() << " (original)" << std::endl;
+                    << " + " << opts.p() << " (original"
+                    << (opts.incremental_compression() ? ", incremental" : "")
+                    << ")" << std::endl;
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
         compress_recursive_original
@@ -197,7 +199,10 @@ namespace strumpack {
           compute_local_samples(Rr, Rc, Sr, Sc, w, 0, d, depth);
         else compute_local_samples(Rr, Rc, Sr, Sc, w, d-dd, dd, depth);
         if (!this->is_compressed()) {
-          if (compute_U_V_bases(Sr, Sc, opts, w, d, depth)) {
+          if (opts.incremental_compression()) {
+            if (compute_U_V_bases_incremental(Sr, Sc, opts, w, d, dd, depth))
+              reduce_local_samples(Rr, Rc, w, 0, d, depth);
+          } else if (compute_U_V_bases(Sr, Sc, opts, w, d, depth)) {
             reduce_local_samples(Rr, Rc, w, 0, d, depth);
             this->_U_state = this->_V_state = State::COMPRESSED;
           } else
@@ -244,7 +249,10 @@ namespace strumpack {
           compute_local_samples(Rr, Rc, Sr, Sc, w, 0, d, depth);
         else compute_local_samples(Rr, Rc, Sr, Sc, w, d-dd, dd, depth);
         if (!this->is_compressed()) {
-          if (compute_U_V_bases(Sr, Sc, opts, w, d, depth)) {
+          if (opts.incremental_compression()) {
+            if (compute_U_V_bases_incremental(Sr, Sc, opts, w, d, dd, depth))
+              reduce_local_samples(Rr, Rc, w, 0, d, depth);
+          } else if (compute_U_V_bases(Sr, Sc, opts, w, d, depth)) {
             reduce_local_samples(Rr, Rc, w, 0, d, depth);
             this->_U_state = this->_V_state = State::COMPRESSED;
           } else
@@ -504,6 +512,173 @@ namespace strumpack {
       }
     }
 
+    /**
+     * Incremental version of compute_U_V_bases. The row and column
+     * bases are handled separately, a basis that was already
+     * compressed in a previous round is kept. For the other, only the
+     * dd new sample columns are processed, see update_sample_basis.
+     */
+    template<typename scalar_t> bool
+    HSSMatrix<scalar_t>::compute_U_V_bases_incremental
+    (DenseM_t& Sr, DenseM_t& Sc, const opts_t& opts,
+     WorkCompress<scalar_t>& w, int d, int dd, int depth) {
+      // a node which was untouched has no basis yet for the first
+      // d-dd columns
+      int d0 = this->is_untouched() ? 0 : d - dd;
+#pragma omp task default(shared)                                        \
+  if(depth < params::task_recursion_cutoff_level)                       \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+      compute_U_basis_incremental(Sr, opts, w, d, d0, depth);
+#pragma omp task default(shared)                                        \
+  if(depth < params::task_recursion_cutoff_level)                       \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+      compute_V_basis_incremental(Sc, opts, w, d, d0, depth);
+#pragma omp taskwait
+      return this->is_compressed();
+    }
+
+    template<typename scalar_t> void
+    HSSMatrix<scalar_t>::compute_U_basis_incremental
+    (DenseM_t& Sr, const opts_t& opts, WorkCompress<scalar_t>& w,
+     int d, int d0, int depth) {
+      if (this->_U_state == State::COMPRESSED) return;
+      int u_rows = this->leaf() ? this->rows() :
+        this->_ch[0]->U_rank()+this->_ch[1]->U_rank();
+      DenseMW_t lSr(u_rows, d, Sr, w.offset.second, 0);
+      bool max_rank = d - opts.p() >= opts.max_rank();
+      // the ID can only find a rank < d-p if the samples are
+      // numerically rank deficient, skip it as long as they are not
+      if (max_rank ||
+          update_sample_basis
+          (opts, lSr, w.Qr, d0, w.lvl, depth) < d) {
+        auto rtol = opts.rel_tol() / w.lvl;
+        auto atol = opts.abs_tol() / w.lvl;
+        lSr.ID_row(_U.E(), _U.P(), w.Jr, rtol, atol, opts.max_rank(), depth);
+        STRUMPACK_ID_FLOPS(ID_row_flops(lSr, _U.cols()));
+        _U.check();  assert(_U.cols() == w.Jr.size());
+        // same acceptance criterion as compute_U_V_bases
+        if (max_rank || int(_U.cols()) < d - opts.p()) {
+          w.Qr.clear();
+          this->_U_rank = _U.cols();
+          this->_U_rows = _U.rows();
+          w.Ir.reserve(_U.cols());
+          if (this->leaf())
+            for (auto i : w.Jr) w.Ir.push_back(w.offset.first + i);
+          else {
+            auto r0 = w.c[0].Ir.size();
+            for (auto i : w.Jr)
+              w.Ir.push_back((i < r0) ? w.c[0].Ir[i] : w.c[1].Ir[i-r0]);
+          }
+          this->_U_state = State::COMPRESSED;
+          return;
+        }
+        w.Jr.clear();
+      }
+      this->_U_state = State::PARTIALLY_COMPRESSED;
+    }
+
+    template<typename scalar_t> void
+    HSSMatrix<scalar_t>::compute_V_basis_incremental
+    (DenseM_t& Sc, const opts_t& opts, WorkCompress<scalar_t>& w,
+     int d, int d0, int depth) {
+      if (this->_V_state == State::COMPRESSED) return;
+      int v_rows = this->leaf() ? this->rows() :
+        this->_ch[0]->V_rank()+this->_ch[1]->V_rank();
+      DenseMW_t lSc(v_rows, d, Sc, w.offset.second, 0);
+      bool max_rank = d - opts.p() >= opts.max_rank();
+      if (max_rank ||
+          update_sample_basis
+          (opts, lSc, w.Qc, d0, w.lvl, depth) < d) {
+        auto rtol = opts.rel_tol() / w.lvl;
+        auto atol = opts.abs_tol() / w.lvl;
+        lSc.ID_row(_V.E(), _V.P(), w.Jc, rtol, atol, opts.max_rank(), depth);
+        STRUMPACK_ID_FLOPS(ID_row_flops(lSc, _V.cols()));
+        _V.check();  assert(_V.cols() == w.Jc.size());
+        if (max_rank || int(_V.cols()) < d - opts.p()) {
+          w.Qc.clear();
+          this->_V_rank = _V.cols();
+          this->_V_rows = _V.rows();
+          w.Ic.reserve(_V.cols());
+          if (this->leaf())
+            for (auto j : w.Jc) w.Ic.push_back(w.offset.second + j);
+          else {
+            auto r0 = w.c[0].Ic.size();
+            for (auto j : w.Jc)
+              w.Ic.push_back((j < r0) ? w.c[0].Ic[j] : w.c[1].Ic[j-r0]);
+          }
+          this->_V_state = State::COMPRESSED;
+          return;
+        }
+        w.Jc.clear();
+      }
+      this->_V_state = State::PARTIALLY_COMPRESSED;
+    }
+
+    /**
+     * Extend the orthonormal basis Q for the columns S(:,0:d0) with
+     * the new columns S(:,d0:end). The new columns are projected out
+     * of Q (twice, classical Gram-Schmidt), then a rank revealing QR
+     * selects the columns that add to the numerical range of S, and
+     * those are orthonormalized and appended to Q. The relative
+     * tolerance is taken with respect to the largest row norm of all
+     * of S, which is the largest pivot of the QR factorization in the
+     * ID (ID_row) of compute_U_V_bases, so the rank is estimated
+     * against the same reference as in the non-incremental
+     * algorithm. Returns the estimated rank of S, which is Q.cols().
+     */
+    template<typename scalar_t> int
+    HSSMatrix<scalar_t>::update_sample_basis
+    (const opts_t& opts, const DenseM_t& S,
+     DenseM_t& Q, int d0, int L, int depth) {
+      int m = S.rows(), n = S.cols() - d0;
+      if (d0 == 0) Q.clear();
+      int k = Q.cols();
+      if (k >= m || n <= 0) return k;
+      DenseM_t X(m, n, S, 0, d0);
+      if (k) {
+        TIMER_TIME(TaskType::ORTHO, 1, t_ortho);
+        DenseM_t QtX(k, n);
+        DenseMW_t Qk(m, k, Q, 0, 0);
+        for (int i=0; i<2; i++) {
+          gemm(Trans::C, Trans::N, scalar_t(1.), Qk, X,
+               scalar_t(0.), QtX, depth);
+          gemm(Trans::N, Trans::N, scalar_t(-1.), Qk, QtX,
+               scalar_t(1.), X, depth);
+        }
+        TIMER_STOP(t_ortho);
+        STRUMPACK_ORTHO_FLOPS
+          (2 * (gemm_flops(Trans::C, Trans::N, scalar_t(1.), Qk, X, scalar_t(0.)) +
+                gemm_flops(Trans::N, Trans::N, scalar_t(-1.), Qk, QtX, scalar_t(1.))));
+      }
+      real_t s_max(0.);
+      for (int i=0; i<m; i++) {
+        real_t si(0.);
+        for (std::size_t j=0; j<S.cols(); j++)
+          si += std::real(S(i,j) * std::conj(S(i,j)));
+        s_max = std::max(s_max, si);
+      }
+      s_max = std::sqrt(s_max);
+      DenseM_t Xr(X);
+      std::vector<int> piv(n);
+      std::unique_ptr<scalar_t[]> tau(new scalar_t[std::min(m, n)]);
+      int rank = 0;
+      auto atol = opts.abs_tol() / L;
+      auto rtol = opts.rel_tol() / L;
+      blas::geqp3tol(m, n, Xr.data(), Xr.ld(), piv.data(), tau.get(),
+                     rank, real_t(0.), std::max(atol, rtol * s_max), depth);
+      STRUMPACK_QR_FLOPS(blas::geqp3_flops(m, n));
+      rank = std::min(rank, m - k);
+      if (rank == 0) return k;
+      Q.resize(m, k+rank);
+      for (int j=0; j<rank; j++)
+        copy(m, 1, X, 0, piv[j]-1, Q, 0, k+j);
+      DenseMW_t Qnew(m, rank, Q, 0, k);
+      scalar_t r_min, r_max;
+      Qnew.orthogonalize(r_max, r_min, depth);
+      STRUMPACK_QR_FLOPS(orthogonalize_flops(Qnew));
+      return k + rank;
+    }
+
     template<typename scalar_t> void HSSMatrix<scalar_t>::reduce_local_samples
     (DenseM_t& Rr, DenseM_t& Rc, WorkCompress<scalar_t>& w,
      int d0, int d, int depth) {
@@ -154,7 +154,9 @@ namespace strumpack {
       case CompressionAlgorithm::STABLE:
         compress_stable(A, opts); break;
       case CompressionAlgorithm::HARD_RESTART:
-        compress_hard_restart(A, opts); break;
+        if (opts.incremental_compression()) compress_original(A, opts);
+        else compress_hard_restart(A, opts);
+        break;
       default:
         std::cout << "Compression algorithm not recognized!" << std::endl;
       };
@@ -169,7 +171,9 @@ namespace strumpack {
       case CompressionAlgorithm::STABLE:
         compress_stable(Amult, Aelem, opts); break;
       case CompressionAlgorithm::HARD_RESTART:
-        compress_hard_restart(Amult, Aelem, opts); break;
+        if (opts.incremental_compression()) compress_original(Amult, Aelem, opts);
+        else compress_hard_restart(Amult, Aelem, opts);
+        break;
       default:
         std::cout << "Compression algorithm not recognized!" << std::endl;
       };
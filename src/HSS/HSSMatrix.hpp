@@ -539,6 +539,18 @@ namespace strumpack {
       void compute_V_basis_stable
       (DenseM_t& Sc, const opts_t& opts,
        WorkCompress<scalar_t>& w, int d, int dd, int depth);
+      bool compute_U_V_bases_incremental
+      (DenseM_t& Sr, DenseM_t& Sc, const opts_t& opts,
+       WorkCompress<scalar_t>& w, int d, int dd, int depth);
+      void compute_U_basis_incremental
+      (DenseM_t& Sr, const opts_t& opts,
+       WorkCompress<scalar_t>& w, int d, int d0, int depth);
+      void compute_V_basis_incremental
+      (DenseM_t& Sc, const opts_t& opts,
+       WorkCompress<scalar_t>& w, int d, int d0, int depth);
+      int update_sample_basis
+      (const opts_t& opts, const DenseM_t& S,
+       DenseM_t& Q, int d0, int L, int depth);
       void reduce_local_samples
       (DenseM_t& Rr, DenseM_t& Rc, WorkCompress<scalar_t>& w,
        int d0, int d, int depth);
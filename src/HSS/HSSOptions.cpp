@@ -77,6 +77,8 @@ namespace strumpack {
          {"hss_enable_sync",           no_argument, 0, 15},
          {"hss_disable_sync",          no_argument, 0, 16},
          {"hss_log_ranks",             no_argument, 0, 17},
+         {"hss_enable_incremental",    no_argument, 0, 18},
+         {"hss_disable_incremental",   no_argument, 0, 19},
          {"hss_verbose",               no_argument, 0, 'v'},
          {"hss_quiet",                 no_argument, 0, 'q'},
          {"help",                      no_argument, 0, 'h'},
@@ -135,9 +137,11 @@ namespace strumpack {
             set_random_engine(random::RandomEngine::LINEAR);
           else if (s.compare("mersenne") == 0)
             set_random_engine(random::RandomEngine::MERSENNE);
+          else if (s.compare("philox") == 0)
+            set_random_engine(random::RandomEngine::PHILOX);
           else
             std::cerr << "# WARNING: random number engine not recognized,"
-                      << " use 'linear' or 'mersenne'." << std::endl;
+                      << " use 'linear', 'mersenne' or 'philox'." << std::endl;
         } break;
         case 10: {
           std::istringstream iss(optarg);
@@ -172,6 +176,8 @@ namespace strumpack {
         case 15: { set_synchronized_compression(true); } break;
         case 16: { set_synchronized_compression(false); } break;
         case 17: { set_log_ranks(true); } break;
+        case 18: { set_incremental_compression(true); } break;
+        case 19: { set_incremental_compression(false); } break;
         case 'v': set_verbose(true); break;
         case 'q': set_verbose(false); break;
         case 'h': describe_options(); break;
@@ -201,7 +207,7 @@ namespace strumpack {
                 << max_rank() << ")" << std::endl
                 << "#   --hss_random_distribution normal|uniform (default "
                 << get_name(random_distribution()) << ")" << std::endl
-                << "#   --hss_random_engine linear|mersenne (default "
+                << "#   --hss_random_engine linear|mersenne|philox (default "
                 << get_name(random_engine()) << ")" << std::endl
                 << "#   --hss_compression_algorithm original|stable|hard_restart (default "
                 << get_name(compression_algorithm())<< ")" << std::endl
@@ -219,6 +225,10 @@ namespace strumpack {
                 << (!synchronized_compression()) << ")" << std::endl
                 << "#   --hss_log_ranks (default "
                 << log_ranks() << ")" << std::endl
+                << "#   --hss_enable_incremental (default "
+                << incremental_compression() << ")" << std::endl
+                << "#   --hss_disable_incremental (default "
+                << (!incremental_compression()) << ")" << std::endl
                 << "#   --hss_verbose or -v (default "
                 << verbose() << ")" << std::endl
                 << "#   --hss_quiet or -q (default "
@@ -264,6 +264,21 @@ namespace strumpack {
         sync_ = sync;
       }
 
+      /**
+       * Make the adaptive ORIGINAL and HARD_RESTART compression
+       * algorithms incremental: an orthonormal basis for the random
+       * samples of each node is kept and only extended with the new
+       * sample columns, and the interpolative decomposition is only
+       * computed once this basis indicates the rank has been
+       * found. Compressed row/column bases are kept when more samples
+       * are added. With this option, HARD_RESTART behaves as
+       * ORIGINAL. Currently only used by the sequential/threaded HSS
+       * code, not by HSSMatrixMPI.
+       */
+      void set_incremental_compression(bool incremental) {
+        incremental_ = incremental;
+      }
+
       /**
        * Log the HSS ranks to a file. TODO is this currently
        * supported??
@@ -408,6 +423,14 @@ namespace strumpack {
        */
       bool synchronized_compression() const { return sync_; }
 
+      /**
+       * Incrementally update the sample bases in the adaptive
+       * compression algorithms?
+       * \return True if incremental compression is used, else False.
+       * \see set_incremental_compression
+       */
+      bool incremental_compression() const { return incremental_; }
+
       /**
        * Check if the ranks should be printed to a log file.  __NOT
        * supported currently__
@@ -458,6 +481,7 @@ namespace strumpack {
       bool log_ranks_ = false;
       CompressionAlgorithm compress_algo_ = CompressionAlgorithm::STABLE;
       bool sync_ = false;
+      bool incremental_ = false;
       ClusteringAlgorithm clustering_algo_ = ClusteringAlgorithm::TWO_MEANS;
       int approximate_neighbors_ = 64;
       int ann_iterations_ = 5;
@@ -76,6 +76,15 @@ namespace strumpack {
     return "UNKNOWN";
   }
 
+  std::string get_name(FactorizationType f) {
+    switch (f) {
+    case FactorizationType::LU: return "lu";
+    case FactorizationType::CHOLESKY: return "cholesky";
+    case FactorizationType::LDLT: return "ldlt";
+    }
+    return "UNKNOWN";
+  }
+
   MatchingJob get_matching(int job) {
     if (job < 0 || job > 6)
       std::cerr << "ERROR: Matching job not recognized!!" << std::endl;
@@ -152,6 +161,16 @@ namespace strumpack {
        {"sp_disable_gpu",               no_argument, 0, 37},
        {"sp_gpu_streams",               required_argument, 0, 38},
        {"sp_lossy_precision",           required_argument, 0, 39},
+       {"sp_factorization",             required_argument, 0, 40},
+       {"sp_enable_out_of_core",        no_argument, 0, 41},
+       {"sp_disable_out_of_core",       no_argument, 0, 42},
+       {"sp_out_of_core_dir",           required_argument, 0, 43},
+       {"sp_amalgamation_tol",          required_argument, 0, 44},
+       {"sp_batch_front_size",          required_argument, 0, 45},
+       {"sp_trace_file",                required_argument, 0, 46},
+       {"sp_enable_assembly_maps",      no_argument, 0, 47},
+       {"sp_disable_assembly_maps",     no_argument, 0, 48},
+       {"sp_tiled_front_size",          required_argument, 0, 49},
        {"sp_verbose",                   no_argument, 0, 'v'},
        {"sp_quiet",                     no_argument, 0, 'q'},
        {"help",                         no_argument, 0, 'h'},
@@ -317,6 +336,39 @@ namespace strumpack {
         iss >> lossy_precision_;
         set_lossy_precision(lossy_precision_);
       } break;
+      case 40: {
+        std::string s; std::istringstream iss(optarg); iss >> s;
+        for (auto& c : s) c = std::toupper(c);
+        if (s == "LU") set_factorization(FactorizationType::LU);
+        else if (s == "CHOLESKY") set_factorization(FactorizationType::CHOLESKY);
+        else if (s == "LDLT") set_factorization(FactorizationType::LDLT);
+        else std::cerr << "# WARNING: factorization type not"
+               " recognized, use 'lu', 'cholesky' or 'ldlt'" << std::endl;
+      } break;
+      case 41: enable_out_of_core(); break;
+      case 42: disable_out_of_core(); break;
+      case 43: set_out_of_core_dir(optarg); break;
+      case 44: {
+        std::istringstream iss(optarg);
+        iss >> amalgamation_tol_;
+        set_amalgamation_tol(amalgamation_tol_);
+      } break;
+      case 45: {
+        std::istringstream iss(optarg);
+        iss >> batch_front_size_;
+        if (batch_front_size_ > 32)
+          std::cerr << "# WARNING: sp_batch_front_size should be at"
+                    << " most 32, using 32" << std::endl;
+        set_batch_front_size(batch_front_size_);
+      } break;
+      case 46: set_trace_file(optarg); break;
+      case 47: enable_assembly_maps(); break;
+      case 48: disable_assembly_maps(); break;
+      case 49: {
+        std::istringstream iss(optarg);
+        iss >> tiled_front_size_;
+        set_tiled_front_size(tiled_front_size_);
+      } break;
       case 'h': { describe_options(); } break;
       case 'v': set_verbose(true); break;
       case 'q': set_verbose(false); break;
@@ -372,6 +424,10 @@ namespace strumpack {
               << " need to provide the sizes." << std::endl;
     std::cout << "#   --sp_nd_param int (default " << nd_param() << ")"
               << std::endl;
+    std::cout << "#   --sp_amalgamation_tol real [0,1) (default "
+              << amalgamation_tol() << ")" << std::endl
+              << "#          fraction of explicit zeros allowed when merging"
+              << " separator subtrees, 0 disables" << std::endl;
     std::cout << "#   --sp_nx int (default " << nx() << ")"
               << std::endl;
     std::cout << "#   --sp_ny int (default " << ny() << ")"
@@ -412,7 +468,7 @@ namespace strumpack {
     for (int i=0; i<7; i++)
       std::cout << "#      " << i << " " <<
         get_description(get_matching(i)) << std::endl;
-    std::cout << "#   --sp_compression [none|hss|blr|hodlr|lossy]" << std::endl
+    std::cout << "#   --sp_compression [none|hss|blr|hodlr|lossy|lossless]" << std::endl
               << "#          type of rank-structured compression to use"
               << std::endl;
     std::cout << "#   --sp_compression_min_sep_size (default "
@@ -440,6 +496,34 @@ namespace strumpack {
               << lossy_precision() << ")" << std::endl
               << "#          lossy compression precision" << std::endl
               << "#          (for lossless use <= 0)" << std::endl;
+    std::cout << "#   --sp_factorization [lu|cholesky|ldlt] (default "
+              << get_name(factorization()) << ")" << std::endl
+              << "#          dense factorization used for the fronts,"
+              << std::endl
+              << "#          cholesky/ldlt require a symmetric matrix"
+              << std::endl;
+    std::cout << "#   --sp_enable_out_of_core" << std::endl;
+    std::cout << "#   --sp_disable_out_of_core" << std::endl;
+    std::cout << "#   --sp_out_of_core_dir dir (default $TMPDIR or .)"
+              << std::endl
+              << "#          directory for the out-of-core factors"
+              << std::endl;
+    std::cout << "#   --sp_batch_front_size int [0,32] (default "
+              << batch_front_size() << ")" << std::endl
+              << "#          max separator size for batched factorization"
+              << " of small fronts, 0 disables" << std::endl;
+    std::cout << "#   --sp_tiled_front_size int (default "
+              << tiled_front_size() << ")" << std::endl
+              << "#          min separator size for tiled, task based"
+              << " factorization of dense fronts, 0 disables" << std::endl;
+    std::cout << "#   --sp_trace_file file (default none)" << std::endl
+              << "#          write a per-front trace of the factorization"
+              << std::endl
+              << "#          in Chrome trace (JSON) format" << std::endl;
+    std::cout << "#   --sp_enable_assembly_maps" << std::endl
+              << "#          keep the front assembly maps to speed up"
+              << " refactorization" << std::endl;
+    std::cout << "#   --sp_disable_assembly_maps" << std::endl;
     std::cout << "#   --sp_verbose or -v (default " << verbose() << ")"
               << std::endl;
     std::cout << "#   --sp_quiet or -q (default " << !verbose() << ")"
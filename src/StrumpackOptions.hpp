@@ -33,6 +33,8 @@
 #define SPOPTIONS_HPP
 
 #include <limits>
+#include <algorithm>
+#include <string>
 
 #include "dense/BLASLAPACKWrapper.hpp"
 #include "HSS/HSSOptions.hpp"
@@ -86,6 +88,28 @@ namespace strumpack {
    */
   std::string get_name(CompressionType comp);
 
+  /**
+   * Enumeration of the dense factorizations that can be used for the
+   * frontal matrices. The symmetric variants (CHOLESKY and LDLT)
+   * only store the lower triangular factor and only assemble the
+   * lower triangular part of the contribution blocks. They require
+   * the input matrix to be symmetric (or Hermitian for CHOLESKY),
+   * and currently only work without compression.
+   * \ingroup Enumerations
+   */
+  enum class FactorizationType {
+    LU,        /*!< LU with partial pivoting, for general matrices     */
+    CHOLESKY,  /*!< Cholesky, for symmetric (Hermitian) positive
+                 definite matrices                                    */
+    LDLT       /*!< LDL^T, with Bunch-Kaufman pivoting in the fronts,
+                 for symmetric (possibly indefinite) matrices         */
+  };
+
+  /**
+   * Return a name/string for the FactorizationType.
+   */
+  std::string get_name(FactorizationType f);
+
 
   /**
    * Enumeration of possible matching algorithms, used for permutation
@@ -307,6 +331,23 @@ namespace strumpack {
     void set_nd_param(int nd_param)
     { assert(nd_param>=0); nd_param_ = nd_param; }
 
+    /**
+     * Set the tolerance for amalgamation of the separator tree. After
+     * the fill reducing reordering, small subtrees of the separator
+     * tree are merged into a single separator, as long as the
+     * fraction of explicitly stored zeros in the (dense) front
+     * factors of the merged separator stays below this tolerance.
+     * This leads to fewer, larger fronts, which are more efficient
+     * for BLAS3 and have less task overhead, at the cost of more
+     * (explicitly stored) fill. Amalgamation is disabled with a value
+     * of 0 (the default).
+     *
+     * \param tol tolerance, should be in [0,1)
+     * \see amalgamation_tol()
+     */
+    void set_amalgamation_tol(double tol)
+    { assert(tol >= 0. && tol < 1.); amalgamation_tol_ = tol; }
+
     /**
      * Set the mesh dimensions. This is only useful when the sparse
      * matrix was generated by a stencil on a regular 1d, 2d or 3d
@@ -511,6 +552,28 @@ namespace strumpack {
      */
     void set_compression(CompressionType c) { comp_ = c; }
 
+    /**
+     * Set the type of dense factorization used for the frontal
+     * matrices. Use FactorizationType::CHOLESKY or
+     * FactorizationType::LDLT for symmetric matrices, this roughly
+     * halves the factor memory and the factorization flops. With a
+     * symmetric factorization, matching and equilibration are not
+     * applied, since they would destroy the symmetry. The matching
+     * job is then set to MatchingJob::NONE, with a warning unless it
+     * was already NONE.
+     *
+     * The input matrix must be symmetric (Hermitian positive
+     * definite for CHOLESKY, complex symmetric for LDLT with complex
+     * scalars). This is not checked, only the lower triangular part
+     * of the matrix is used. The factorization returns
+     * ReturnCode::ZERO_PIVOT if the Cholesky factorization finds a
+     * non-positive pivot.
+     *
+     * \param f factorization type
+     * \see factorization(), set_compression()
+     */
+    void set_factorization(FactorizationType f) { fact_ = f; }
+
     /**
      * Set the relative compression tolerance to be used for low-rank
      * compression. This currently affects BLR, HSS, HODLR, HODBF,
@@ -689,6 +752,108 @@ namespace strumpack {
      */
     void set_print_root_front_stats(bool b) { print_root_front_stats_ = b; }
 
+    /**
+     * Enable out-of-core storage of the factors. The factors of the
+     * dense fronts are written to a file after they are computed,
+     * and read back, ahead of time, during the solve phase.
+     *
+     * \see set_out_of_core_dir()
+     */
+    void enable_out_of_core() { ooc_ = true; }
+
+    /**
+     * Disable out-of-core storage of the factors, keep all factors
+     * in memory (default).
+     */
+    void disable_out_of_core() { ooc_ = false; }
+
+    /**
+     * Set the directory where the out-of-core factors are written.
+     * When this is empty (default), the directory in the TMPDIR
+     * environment variable is used, or the current directory if
+     * TMPDIR is not set.
+     *
+     * \see enable_out_of_core()
+     */
+    void set_out_of_core_dir(const std::string& dir) { ooc_dir_ = dir; }
+
+    /**
+     * Set the maximum separator size for batched factorization of
+     * small dense fronts on the CPU. Subtrees of the elimination tree
+     * in which all fronts are dense and have a separator of at most
+     * this size are factored level by level, using one OpenMP task
+     * per group of fronts, with small fixed size kernels instead of
+     * calls to BLAS/LAPACK. This is disabled when set to 0 (the
+     * default). The maximum is 32, larger values are set to 32.
+     *
+     * \param s maximum separator size, in [0,32]
+     * \see batch_front_size()
+     */
+    void set_batch_front_size(int s)
+    { assert(s >= 0); batch_front_size_ = std::min(s, 32); }
+
+    /**
+     * Set the minimum separator size for which a dense front is
+     * factored with a tiled LU factorization, using OpenMP tasks with
+     * dependencies, instead of with (multithreaded) BLAS/LAPACK
+     * calls. This lets the update of the Schur complement F22 overlap
+     * with the factorization of the next panels. This is only used
+     * with more than one thread, and if STRUMPACK was compiled with
+     * support for OpenMP task dependencies. It only applies to the
+     * root front of the (shared memory) elimination tree, or of the
+     * local subtrees with MPI: the other fronts are factored inside
+     * OpenMP tasks, where a nested parallel region for the tiles
+     * would run on a single thread. Set to 0 to disable.
+     *
+     * \param s minimum separator size, >= 0
+     * \see tiled_front_size()
+     */
+    void set_tiled_front_size(int s)
+    { assert(s >= 0); tiled_front_size_ = s; }
+
+    /**
+     * Record a trace of the numerical factorization, and write it to
+     * the file fname, in the Chrome trace event format (JSON). For
+     * every front, the assembly, factorization and extend-add are
+     * recorded, with the thread id, start and end time, front
+     * dimensions, flops and bytes. The trace can be viewed with
+     * chrome://tracing or https://ui.perfetto.dev. With more than one
+     * MPI rank, each rank writes to fname.rank. Tracing is disabled
+     * when fname is empty (the default).
+     *
+     * \param fname name of the trace file, or empty to disable
+     * \see trace_file(), FrontTrace
+     */
+    void set_trace_file(const std::string& fname) { trace_file_ = fname; }
+
+    /**
+     * Keep, for every dense front, a map from the nonzeros of the
+     * sparse matrix to their position in the front, and the map from
+     * the contribution block to the parent front. These are built
+     * during the first factorization. When the matrix values are
+     * updated (with update_matrix_values), the next factorization
+     * uses these maps to assemble the fronts with a direct
+     * scatter-add, instead of searching the sparse matrix rows and
+     * the parent indices again. The sparse solver also keeps, for
+     * every nonzero of the permuted matrix, its position in the
+     * matrix passed to update_matrix_values. Later updates then
+     * gather the new values (with the matching and equilibration
+     * scaling) directly into the permuted matrix, instead of copying
+     * the input and permuting it again. This requires extra memory,
+     * roughly three integers per nonzero of the (permuted) sparse
+     * matrix.
+     *
+     * \see disable_assembly_maps(), assembly_maps()
+     */
+    void enable_assembly_maps() { assembly_maps_ = true; }
+
+    /**
+     * Do not keep the assembly maps, this is the default.
+     *
+     * \see enable_assembly_maps()
+     */
+    void disable_assembly_maps() { assembly_maps_ = false; }
+
     /**
      * Check if verbose output is enabled.
      * \see set_verbose()
@@ -743,6 +908,13 @@ namespace strumpack {
      */
     int nd_param() const { return nd_param_; }
 
+    /**
+     * Return the tolerance for amalgamation of the separator tree,
+     * 0 means amalgamation is disabled.
+     * \see set_amalgamation_tol()
+     */
+    double amalgamation_tol() const { return amalgamation_tol_; }
+
     /**
      * Get the specified nx mesh dimension.
      * \see set_nx()
@@ -816,6 +988,23 @@ namespace strumpack {
      */
     CompressionType compression() const { return comp_; }
 
+    /**
+     * Get the type of dense factorization to use for the fronts.
+     * \see set_factorization()
+     */
+    FactorizationType factorization() const { return fact_; }
+
+    /**
+     * Check whether a symmetric (Cholesky or LDL^T) multifrontal
+     * factorization will be used. This is only the case when no
+     * compression is used.
+     * \see set_factorization(), set_compression()
+     */
+    bool symmetric_factorization() const {
+      return fact_ != FactorizationType::LU &&
+        comp_ == CompressionType::NONE;
+    }
+
 
     /**
      * Return the relative compression tolerance used for the
@@ -991,6 +1180,46 @@ namespace strumpack {
      */
     bool print_root_front_stats() const { return print_root_front_stats_; }
 
+    /**
+     * Check whether the factors are stored out-of-core.
+     * \see enable_out_of_core()
+     */
+    bool out_of_core() const { return ooc_; }
+
+    /**
+     * Get the directory for the out-of-core factors.
+     * \see set_out_of_core_dir()
+     */
+    const std::string& out_of_core_dir() const { return ooc_dir_; }
+
+    /**
+     * Get the maximum separator size for batched factorization of
+     * small fronts, 0 means batching is disabled.
+     * \see set_batch_front_size()
+     */
+    int batch_front_size() const { return batch_front_size_; }
+
+    /**
+     * Get the minimum separator size for the tiled factorization of
+     * dense fronts, 0 means the tiled factorization is disabled.
+     * \see set_tiled_front_size()
+     */
+    int tiled_front_size() const { return tiled_front_size_; }
+
+    /**
+     * Get the name of the file for the factorization trace, empty if
+     * tracing is disabled.
+     * \see set_trace_file()
+     */
+    const std::string& trace_file() const { return trace_file_; }
+
+    /**
+     * Check if the fronts keep their assembly maps for fast
+     * refactorization.
+     * \see enable_assembly_maps()
+     */
+    bool assembly_maps() const { return assembly_maps_; }
+
     /**
      * Get a (const) reference to an object holding various options
      * pertaining to the HSS code, and data structures.
@@ -1066,6 +1295,7 @@ namespace strumpack {
     /** Reordering options */
     ReorderingStrategy reordering_method_ = ReorderingStrategy::METIS;
     int nd_param_ = 8;
+    double amalgamation_tol_ = 0.;
     int nx_ = 1;
     int ny_ = 1;
     int nz_ = 1;
@@ -1088,6 +1318,25 @@ namespace strumpack {
     /** compression options */
     CompressionType comp_ = CompressionType::NONE;
 
+    /** factorization type */
+    FactorizationType fact_ = FactorizationType::LU;
+
+    /** out-of-core options */
+    bool ooc_ = false;
+    std::string ooc_dir_;
+
+    /** batched small front factorization */
+    int batch_front_size_ = 0;
+
+    /** tiled factorization of large dense fronts */
+    int tiled_front_size_ = 2048;
+
+    /** per-front factorization trace */
+    std::string trace_file_;
+
+    /** reuse front assembly maps for refactorization */
+    bool assembly_maps_ = false;
+
     /** HSS options */
     int hss_min_front_size_ = 5000;
     int hss_min_sep_size_ = 1000;
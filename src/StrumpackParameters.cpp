@@ -26,6 +26,10 @@
  *             Division).
  *
  */
+#include <new>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
 #include "StrumpackParameters.hpp"
 #if defined(_OPENMP)
 #include <omp.h>
@@ -50,35 +54,99 @@ namespace strumpack {
     int task_recursion_cutoff_level = 0;
 #endif
 
-    std::atomic<long long int> flops(0);
-    std::atomic<long long int> bytes_moved(0);
-    std::atomic<long long int> memory(0);
-    std::atomic<long long int> peak_memory(0);
-    std::atomic<long long int> device_memory(0);
-    std::atomic<long long int> peak_device_memory(0);
-
-    std::atomic<long long int> CB_sample_flops(0);
-    std::atomic<long long int> sparse_sample_flops(0);
-    std::atomic<long long int> extraction_flops(0);
-    std::atomic<long long int> ULV_factor_flops(0);
-    std::atomic<long long int> schur_flops(0);
-    std::atomic<long long int> full_rank_flops(0);
-    std::atomic<long long int> random_flops(0);
-    std::atomic<long long int> ID_flops(0);
-    std::atomic<long long int> QR_flops(0);
-    std::atomic<long long int> ortho_flops(0);
-    std::atomic<long long int> reduce_sample_flops(0);
-    std::atomic<long long int> update_sample_flops(0);
-    std::atomic<long long int> hss_solve_flops(0);
-
-    std::atomic<long long int> f11_fill_flops(0);
-    std::atomic<long long int> f12_fill_flops(0);
-    std::atomic<long long int> f21_fill_flops(0);
-    std::atomic<long long int> f22_fill_flops(0);
-
-    std::atomic<long long int> f21_mult_flops(0);
-    std::atomic<long long int> invf11_mult_flops(0);
-    std::atomic<long long int> f12_mult_flops(0);
+    int ThreadCounter::slots() {
+      // computed on first use, after the application had a chance to
+      // set the number of threads
+#if defined(_OPENMP)
+      static const int n =
+        std::max(omp_get_max_threads(),
+                 int(std::thread::hardware_concurrency()));
+#else
+      static const int n =
+        std::max(1, int(std::thread::hardware_concurrency()));
+#endif
+      return n;
+    }
+
+    std::atomic<int> ThreadCounter::next_slot_(0);
+
+    // allocate slots()+1 slots (the last one is shared), aligned to
+    // 64 bytes. If another thread was first, use its slots.
+    ThreadCounter::Slot* ThreadCounter::SlotArray::allocate() const {
+      const int n = slots();
+      std::unique_ptr<char[]> mem(new char[(n+1)*sizeof(Slot) + 64]);
+      auto s = reinterpret_cast<Slot*>
+        ((reinterpret_cast<std::uintptr_t>(mem.get()) + 63) & ~std::uintptr_t(63));
+      for (int i=0; i<=n; i++) {
+        new (s+i) Slot();
+        s[i].v = 0;
+      }
+      Slot* expected = nullptr;
+      if (s_.compare_exchange_strong(expected, s)) {
+        mem_ = std::move(mem);
+        return s;
+      }
+      return expected;
+    }
+
+    ThreadCounter& ThreadCounter::operator=(long long int n) {
+      auto s = s_.get();
+      for (int i=0; i<=slots(); i++) s[i].v = 0;
+      s[slots()].v = n;
+      return *this;
+    }
+
+    long long int ThreadCounter::load() const {
+      auto s = s_.get();
+      long long int n = 0;
+      for (int i=0; i<=slots(); i++)
+        n += s[i].v.load(std::memory_order_relaxed);
+      return n;
+    }
+
+    long long int MemoryCounter::peak() const {
+      auto h = hwm_.get();
+      long long int p = 0;
+      for (int i=0; i<=ThreadCounter::slots(); i++)
+        p = std::max(p, h[i].v.load(std::memory_order_relaxed));
+      return p;
+    }
+
+    void MemoryCounter::reset_peak() {
+      auto h = hwm_.get();
+      for (int i=0; i<=ThreadCounter::slots(); i++)
+        h[i].v = m_.load();
+    }
+
+    ThreadCounter flops;
+    ThreadCounter bytes_moved;
+    MemoryCounter memory;
+    MemoryCounter device_memory;
+    PeakMemory peak_memory(memory);
+    PeakMemory peak_device_memory(device_memory);
+
+    ThreadCounter CB_sample_flops;
+    ThreadCounter sparse_sample_flops;
+    ThreadCounter extraction_flops;
+    ThreadCounter ULV_factor_flops;
+    ThreadCounter schur_flops;
+    ThreadCounter full_rank_flops;
+    ThreadCounter random_flops;
+    ThreadCounter ID_flops;
+    ThreadCounter QR_flops;
+    ThreadCounter ortho_flops;
+    ThreadCounter reduce_sample_flops;
+    ThreadCounter update_sample_flops;
+    ThreadCounter hss_solve_flops;
+
+    ThreadCounter f11_fill_flops;
+    ThreadCounter f12_fill_flops;
+    ThreadCounter f21_fill_flops;
+    ThreadCounter f22_fill_flops;
+
+    ThreadCounter f21_mult_flops;
+    ThreadCounter invf11_mult_flops;
+    ThreadCounter f12_mult_flops;
 
   } // end namespace params
 } // end namespace strumpack
@@ -32,6 +32,7 @@
 #ifndef STRUMPACK_PARAMETERS_HPP
 #define STRUMPACK_PARAMETERS_HPP
 #include <atomic>
+#include <memory>
 #include <string>
 #include <cmath>
 #include <iostream>
@@ -60,7 +61,10 @@ namespace strumpack { // these are all global variables
   enum class ReturnCode {
     SUCCESS,          /*!< Operation completed successfully. */
     MATRIX_NOT_SET,   /*!< The input matrix was not set.     */
-    REORDERING_ERROR  /*!< The matrix reordering failed.     */
+    REORDERING_ERROR, /*!< The matrix reordering failed.     */
+    FILE_ERROR,       /*!< Reading or writing a file failed. */
+    ZERO_PIVOT        /*!< A zero pivot, or for Cholesky a
+                           non-positive pivot, was found.    */
   };
 
   namespace params {
@@ -70,35 +74,183 @@ namespace strumpack { // these are all global variables
     extern int num_threads;
     extern int task_recursion_cutoff_level;
 
-    extern std::atomic<long long int> flops;
-    extern std::atomic<long long int> bytes_moved;
-    extern std::atomic<long long int> memory;
-    extern std::atomic<long long int> peak_memory;
-    extern std::atomic<long long int> device_memory;
-    extern std::atomic<long long int> peak_device_memory;
-
-    extern std::atomic<long long int> CB_sample_flops;
-    extern std::atomic<long long int> sparse_sample_flops;
-    extern std::atomic<long long int> extraction_flops;
-    extern std::atomic<long long int> ULV_factor_flops;
-    extern std::atomic<long long int> schur_flops;
-    extern std::atomic<long long int> full_rank_flops;
-    extern std::atomic<long long int> random_flops;
-    extern std::atomic<long long int> ID_flops;
-    extern std::atomic<long long int> ortho_flops;
-    extern std::atomic<long long int> QR_flops;
-    extern std::atomic<long long int> reduce_sample_flops;
-    extern std::atomic<long long int> update_sample_flops;
-    extern std::atomic<long long int> hss_solve_flops;
-
-    extern std::atomic<long long int> f11_fill_flops;
-    extern std::atomic<long long int> f12_fill_flops;
-    extern std::atomic<long long int> f21_fill_flops;
-    extern std::atomic<long long int> f22_fill_flops;
-
-    extern std::atomic<long long int> f21_mult_flops;
-    extern std::atomic<long long int> invf11_mult_flops;
-    extern std::atomic<long long int> f12_mult_flops;
+    /**
+     * Counter with a separate slot for every thread, each in its own
+     * cache line, so that threads can increment the counter without
+     * contention. Reading the counter sums all slots.
+     *
+     * Every thread gets its own slot the first time it uses any
+     * counter. Threads beyond the number of slots share the last
+     * slot, which is then updated atomically. The number of slots is
+     * determined, and the slots are allocated, on first use, not
+     * during static initialization, so the number of threads set by
+     * the application is taken into account. Assigning a value
+     * (reset) is not thread safe, it should be done when no other
+     * thread is updating the counter.
+     */
+    class ThreadCounter {
+    public:
+      ThreadCounter() = default;
+      ThreadCounter(const ThreadCounter&) = delete;
+      ThreadCounter& operator=(const ThreadCounter&) = delete;
+
+      ThreadCounter& operator+=(long long int n) { add(n); return *this; }
+      ThreadCounter& operator-=(long long int n) { add(-n); return *this; }
+      ThreadCounter& operator=(long long int n);
+
+      long long int load() const;
+      operator long long int() const { return load(); }
+
+      /**
+       * Number of per-thread slots, not counting the shared slot.
+       */
+      static int slots();
+
+      /**
+       * Slot of the calling thread, in [0, slots()], slots() is the
+       * shared slot.
+       */
+      static int slot_index() {
+        static thread_local int t = next_slot_++;
+        return t < slots() ? t : slots();
+      }
+
+      struct Slot {
+        std::atomic<long long int> v;
+        char pad[64 - sizeof(std::atomic<long long int>)];
+      };
+
+      /**
+       * slots()+1 slots, aligned to a cache line, allocated by the
+       * first thread that accesses them.
+       */
+      class SlotArray {
+      public:
+        Slot* get() const {
+          auto s = s_.load(std::memory_order_acquire);
+          return s ? s : allocate();
+        }
+      private:
+        mutable std::atomic<Slot*> s_{nullptr};
+        mutable std::unique_ptr<char[]> mem_;
+        Slot* allocate() const;
+      };
+
+    private:
+      SlotArray s_;
+
+      static std::atomic<int> next_slot_;
+
+      void add(long long int n) {
+        auto t = slot_index();
+        auto& v = s_.get()[t].v;
+        if (t == slots()) v.fetch_add(n, std::memory_order_relaxed);
+        else // only the calling thread updates this slot
+          v.store(v.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+      }
+    };
+
+    /**
+     * Memory usage counter. The current usage is a single atomic,
+     * updated with one atomic add, no compare-and-swap. Every thread
+     * records the maximum of the values it produced in its own
+     * (padded) slot, so the maximum over all slots is the true peak
+     * memory usage.
+     */
+    class MemoryCounter {
+    public:
+      MemoryCounter() : m_(0) {}
+      MemoryCounter(const MemoryCounter&) = delete;
+      MemoryCounter& operator=(const MemoryCounter&) = delete;
+
+      MemoryCounter& operator+=(long long int n) {
+        auto v = m_.fetch_add(n, std::memory_order_relaxed) + n;
+        auto t = ThreadCounter::slot_index();
+        auto& h = hwm_.get()[t].v;
+        auto old = h.load(std::memory_order_relaxed);
+        if (t == ThreadCounter::slots())
+          while (v > old && !h.compare_exchange_weak(old, v)) { }
+        else if (v > old) h.store(v, std::memory_order_relaxed);
+        return *this;
+      }
+      MemoryCounter& operator-=(long long int n) {
+        m_.fetch_sub(n, std::memory_order_relaxed);
+        return *this;
+      }
+
+      long long int load() const { return m_.load(); }
+      operator long long int() const { return load(); }
+
+      /**
+       * Peak of the memory usage, since the last call to reset_peak.
+       * The sparse solvers reset the peak at the start of the
+       * numerical factorization.
+       */
+      long long int peak() const;
+
+      /**
+       * Set the peak to the current memory usage.
+       */
+      void reset_peak();
+
+    private:
+      std::atomic<long long int> m_;
+      ThreadCounter::SlotArray hwm_;
+    };
+
+    /**
+     * Read-only view of the peak of a MemoryCounter, for backward
+     * compatibility with the old peak_memory and peak_device_memory
+     * variables. Assigning any value resets the peak to the current
+     * memory usage.
+     *
+     * Deprecated, use memory.peak() and memory.reset_peak() instead.
+     */
+    class PeakMemory {
+    public:
+      explicit PeakMemory(MemoryCounter& m) : m_(m) {}
+      long long int load() const { return m_.peak(); }
+      operator long long int() const { return load(); }
+      PeakMemory& operator=(long long int) {
+        m_.reset_peak();
+        return *this;
+      }
+    private:
+      MemoryCounter& m_;
+    };
+
+    extern ThreadCounter flops;
+    extern ThreadCounter bytes_moved;
+    extern MemoryCounter memory;
+    extern MemoryCounter device_memory;
+    /** Deprecated, use memory.peak() */
+    extern PeakMemory peak_memory;
+    /** Deprecated, use device_memory.peak() */
+    extern PeakMemory peak_device_memory;
+
+    extern ThreadCounter CB_sample_flops;
+    extern ThreadCounter sparse_sample_flops;
+    extern ThreadCounter extraction_flops;
+    extern ThreadCounter ULV_factor_flops;
+    extern ThreadCounter schur_flops;
+    extern ThreadCounter full_rank_flops;
+    extern ThreadCounter random_flops;
+    extern ThreadCounter ID_flops;
+    extern ThreadCounter ortho_flops;
+    extern ThreadCounter QR_flops;
+    extern ThreadCounter reduce_sample_flops;
+    extern ThreadCounter update_sample_flops;
+    extern ThreadCounter hss_solve_flops;
+
+    extern ThreadCounter f11_fill_flops;
+    extern ThreadCounter f12_fill_flops;
+    extern ThreadCounter f21_fill_flops;
+    extern ThreadCounter f22_fill_flops;
+
+    extern ThreadCounter f21_mult_flops;
+    extern ThreadCounter invf11_mult_flops;
+    extern ThreadCounter f12_mult_flops;
 
 #endif //DOXYGEN_SHOULD_SKIP_THIS
 
@@ -153,24 +305,10 @@ namespace strumpack { // these are all global variables
 #define STRUMPACK_HODLR_F12_MULT_FLOPS(n)       \
   strumpack::params::f12_mult_flops += n
 
-#define STRUMPACK_ADD_MEMORY(n) {                                       \
-    strumpack::params::memory += n;                                     \
-    auto new_peak_ = std::max(strumpack::params::memory.load(),         \
-                              strumpack::params::peak_memory.load());   \
-    auto old_peak_ = strumpack::params::peak_memory.load();             \
-    while (new_peak_ > old_peak_ &&                                     \
-           !strumpack::params::peak_memory.compare_exchange_weak        \
-           (old_peak_, new_peak_)) { }                                  \
-  }
-#define STRUMPACK_ADD_DEVICE_MEMORY(n) {                                \
-    strumpack::params::device_memory += n;                              \
-    auto new_peak_ = std::max(strumpack::params::device_memory.load(),  \
-                              strumpack::params::peak_device_memory.load()); \
-    auto old_peak_ = strumpack::params::peak_device_memory.load();      \
-    while (new_peak_ > old_peak_ &&                                     \
-           !strumpack::params::peak_device_memory.compare_exchange_weak \
-           (old_peak_, new_peak_)) { }                                  \
-  }
+#define STRUMPACK_ADD_MEMORY(n)                 \
+  strumpack::params::memory += n;
+#define STRUMPACK_ADD_DEVICE_MEMORY(n)          \
+  strumpack::params::device_memory += n;
 
 #define STRUMPACK_SUB_MEMORY(n)                 \
   strumpack::params::memory -= n;
@@ -26,6 +26,10 @@
  *             Division).
  */
 
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
 #include "StrumpackSparseSolver.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -87,6 +91,7 @@ namespace strumpack {
   StrumpackSparseSolver<scalar_t,integer_t>::set_matrix
   (const CSRMatrix<scalar_t,integer_t>& A) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
+    val_map_.clear();
     factored_ = reordered_ = false;
   }
 
@@ -98,8 +103,10 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
+    if (update_values_from_map(A.size(), A.ptr(), A.val())) return;
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
     permute_matrix_values();
+    setup_value_map(A.size(), A.ptr(), A.ind());
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -108,6 +115,7 @@ namespace strumpack {
    const scalar_t* values, bool symmetric_pattern) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
+    val_map_.clear();
     factored_ = reordered_ = false;
   }
 
@@ -120,9 +128,11 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
+    if (update_values_from_map(N, row_ptr, values)) return;
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
     permute_matrix_values();
+    setup_value_map(N, row_ptr, col_ind);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -138,6 +148,298 @@ namespace strumpack {
     factored_ = false;
   }
 
+  /**
+   * Record, for every nonzero of the permuted matrix mat_, where it
+   * comes from in the (unpermuted) matrix given by row_ptr and
+   * col_ind, and the combined row and column scaling from the
+   * matching and the equilibration. A next call to
+   * update_matrix_values, with the same sparsity pattern, then
+   * simply gathers the new values into mat_, without making a copy
+   * of the matrix and without applying the matching, equilibration,
+   * symmetrization and permutation again. This is only done with
+   * assembly maps enabled, and not with compression, since then the
+   * matrix is reordered again after the permutation.
+   *
+   * The permuted values in mat_ are kept, they are read during the
+   * assembly of the fronts and by the matrix-vector products in
+   * iterative refinement, possibly long after update_matrix_values
+   * returned, and the caller's arrays need not outlive that call. So
+   * the map costs nnz extra integers, and 2N reals for the scaling,
+   * on top of mat_. This replaces the copy of the full matrix (nnz
+   * values and indices) and the temporaries of the symmetrization
+   * and permutation made by every update without the map.
+   */
+  template<typename scalar_t,typename integer_t> void
+  StrumpackSparseSolver<scalar_t,integer_t>::setup_value_map
+  (integer_t N, const integer_t* row_ptr, const integer_t* col_ind) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    val_map_.clear();
+    val_Dr_.clear();
+    val_Dc_.clear();
+    if (!opts_.assembly_maps() || !reordered_ ||
+        opts_.compression() != CompressionType::NONE)
+      return;
+    const auto& iperm = reordering()->iperm();
+    const bool match = matching_.job != MatchingJob::NONE,
+      mscale = matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING,
+      erow = equil_.type == EquilibrationType::ROW ||
+      equil_.type == EquilibrationType::BOTH,
+      ecol = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH;
+    // column c of mat_ is column ocol[c] of the original matrix
+    std::vector<integer_t> ocol(N);
+    for (integer_t c=0; c<N; c++)
+      ocol[c] = match ? matching_.Q[iperm[c]] : iperm[c];
+    if (mscale || erow || ecol) {
+      val_Dr_.resize(N);
+      val_Dc_.resize(N);
+      for (integer_t r=0; r<N; r++) {
+        auto i = iperm[r];
+        val_Dr_[r] = (mscale ? matching_.R[i] : real_t(1.)) *
+          (erow ? equil_.R[i] : real_t(1.));
+        val_Dc_[r] = (mscale ? matching_.C[ocol[r]] : real_t(1.)) *
+          (ecol ? equil_.C[i] : real_t(1.));
+      }
+    }
+    const auto ptr = mat_->ptr();
+    const auto ind = mat_->ind();
+    val_map_.resize(mat_->nnz());
+#pragma omp parallel
+    {
+      std::vector<std::pair<integer_t,integer_t>> row;
+#pragma omp for
+      for (integer_t r=0; r<N; r++) {
+        auto i = iperm[r];
+        row.clear();
+        for (integer_t k=row_ptr[i]; k<row_ptr[i+1]; k++)
+          row.emplace_back(col_ind[k], k);
+        std::sort(row.begin(), row.end());
+        for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+          auto j = ocol[ind[k]];
+          auto e = std::lower_bound
+            (row.begin(), row.end(), std::make_pair(j, integer_t(0)));
+          val_map_[k] = (e != row.end() && e->first == j) ? e->second : -1;
+        }
+      }
+    }
+    val_map_nnz_ = row_ptr[N];
+  }
+
+  /**
+   * Update the values of mat_ using the map set up by
+   * setup_value_map. Returns false if there is no such map, or if it
+   * does not match the number of nonzeros, then the values should be
+   * updated by copying and permuting the matrix.
+   */
+  template<typename scalar_t,typename integer_t> bool
+  StrumpackSparseSolver<scalar_t,integer_t>::update_values_from_map
+  (integer_t N, const integer_t* row_ptr, const scalar_t* values) {
+    if (val_map_.empty() || !opts_.assembly_maps() ||
+        N != mat_->size() || row_ptr[N] != val_map_nnz_)
+      return false;
+    const auto ptr = mat_->ptr();
+    const auto ind = mat_->ind();
+    auto val = mat_->val();
+    const bool scaled = !val_Dr_.empty();
+#pragma omp parallel for
+    for (integer_t r=0; r<N; r++)
+      for (integer_t k=ptr[r]; k<ptr[r+1]; k++) {
+        auto s = val_map_[k];
+        if (s < 0) val[k] = scalar_t(0.);
+        else if (scaled) val[k] = values[s] * val_Dr_[r] * val_Dc_[ind[k]];
+        else val[k] = values[s];
+      }
+    factored_ = false;
+    return true;
+  }
+
+  // identification of the files written by save_factors, the
+  // version should be incremented when the format changes
+  static const char factor_file_magic[8] = "STRMPKF";
+  static const int factor_file_version = 1;
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  StrumpackSparseSolver<scalar_t,integer_t>::save_factors
+  (const std::string& fname) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    if (opts_.compression() != CompressionType::NONE) {
+      std::cerr << "ERROR: save_factors is not supported with "
+                << get_name(opts_.compression()) << " compression"
+                << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (!factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    std::ofstream os(fname, std::ios::out | std::ios::trunc |
+                     std::ios::binary);
+    if (!os) {
+      std::cerr << "ERROR: could not open " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    auto write_ivec = [&os](const std::vector<integer_t>& v) {
+      std::size_t n = v.size();
+      os.write((const char*)&n, sizeof(n));
+      os.write((const char*)v.data(), n*sizeof(integer_t));
+    };
+    auto write_rvec = [&os](const std::vector<real_t>& v) {
+      std::size_t n = v.size();
+      os.write((const char*)&n, sizeof(n));
+      os.write((const char*)v.data(), n*sizeof(real_t));
+    };
+    int fmt[7] = {factor_file_version, 0, 0, 0, int(sizeof(scalar_t)),
+                  int(sizeof(integer_t)), is_complex<scalar_t>()};
+    get_version(fmt[1], fmt[2], fmt[3]);
+    os.write(factor_file_magic, sizeof(factor_file_magic));
+    os.write((const char*)fmt, sizeof(fmt));
+    integer_t n = matrix()->size(), nnz = matrix()->nnz();
+    os.write((const char*)&n, sizeof(n));
+    os.write((const char*)&nnz, sizeof(nnz));
+    int types[2] = {int(opts_.matching()), int(opts_.factorization())};
+    os.write((const char*)types, sizeof(types));
+    write_ivec(matching_.Q);
+    write_rvec(matching_.R);
+    write_rvec(matching_.C);
+    char et = char(equil_.type);
+    os.write(&et, sizeof(et));
+    real_t econd[3] = {equil_.rcond, equil_.ccond, equil_.Amax};
+    os.write((const char*)econd, sizeof(econd));
+    write_rvec(equil_.R);
+    write_rvec(equil_.C);
+    reordering()->write(os);
+    try {
+      tree()->root()->write_factors(os);
+    } catch (std::exception& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (!os) {
+      std::cerr << "ERROR: failed to write " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (opts_.verbose() && is_root_)
+      std::cout << "# factors written to " << fname << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  StrumpackSparseSolver<scalar_t,integer_t>::load_factors
+  (const std::string& fname) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (reordered_) {
+      std::cerr << "ERROR: load_factors should be called after"
+                << " set_matrix, before reorder or factor" << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    std::ifstream is(fname, std::ios::in | std::ios::binary);
+    if (!is) {
+      std::cerr << "ERROR: could not open " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    // these vectors are either empty or have one entry per row
+    std::size_t N = matrix()->size();
+    auto read_ivec = [&is,N](std::vector<integer_t>& v) {
+      std::size_t n = 0;
+      is.read((char*)&n, sizeof(n));
+      if (!is || (n != 0 && n != N))
+        throw std::runtime_error("Invalid vector size in file");
+      v.resize(n);
+      is.read((char*)v.data(), n*sizeof(integer_t));
+    };
+    auto read_rvec = [&is,N](std::vector<real_t>& v) {
+      std::size_t n = 0;
+      is.read((char*)&n, sizeof(n));
+      if (!is || (n != 0 && n != N))
+        throw std::runtime_error("Invalid vector size in file");
+      v.resize(n);
+      is.read((char*)v.data(), n*sizeof(real_t));
+    };
+    char magic[sizeof(factor_file_magic)] = {0};
+    int fmt[7], v[3];
+    is.read(magic, sizeof(magic));
+    is.read((char*)fmt, sizeof(fmt));
+    if (!is || !std::equal(magic, magic+sizeof(magic), factor_file_magic) ||
+        fmt[0] != factor_file_version) {
+      std::cerr << "ERROR: " << fname << " is not a (compatible)"
+                << " STRUMPACK factor file" << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (fmt[4] != int(sizeof(scalar_t)) ||
+        fmt[5] != int(sizeof(integer_t)) ||
+        fmt[6] != int(is_complex<scalar_t>())) {
+      std::cerr << "ERROR: " << fname << " was written with a different"
+                << " scalar or integer type" << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    get_version(v[0], v[1], v[2]);
+    if (v[0] != fmt[1] || v[1] != fmt[2] || v[2] != fmt[3])
+      std::cerr << "Warning, file was created with a different"
+                << " strumpack version (v"
+                << fmt[1] << "." << fmt[2] << "." << fmt[3]
+                << " instead of v"
+                << v[0] << "." << v[1] << "." << v[2]
+                << ")" << std::endl;
+    integer_t n = 0, nnz = 0;
+    is.read((char*)&n, sizeof(n));
+    is.read((char*)&nnz, sizeof(nnz));
+    if (n != matrix()->size()) {
+      std::cerr << "ERROR: the matrix size does not match the size"
+                << " in " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    int types[2];
+    is.read((char*)types, sizeof(types));
+    opts_.set_matching(MatchingJob(types[0]));
+    opts_.set_factorization(FactorizationType(types[1]));
+    opts_.set_compression(CompressionType::NONE);
+    matching_.job = opts_.matching();
+    try {
+      read_ivec(matching_.Q);
+      read_rvec(matching_.R);
+      read_rvec(matching_.C);
+      char et;
+      is.read(&et, sizeof(et));
+      equil_.type = EquilibrationType(et);
+      real_t econd[3];
+      is.read((char*)econd, sizeof(econd));
+      equil_.rcond = econd[0];
+      equil_.ccond = econd[1];
+      equil_.Amax = econd[2];
+      read_rvec(equil_.R);
+      read_rvec(equil_.C);
+      if (!is) throw std::runtime_error("Error reading the factor file");
+      setup_reordering();
+      reordering()->read(is, n);
+    } catch (std::exception& e) {
+      std::cerr << "ERROR: " << e.what() << " " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    // apply matching, scaling and permutation, as in reorder
+    reordered_ = true;
+    permute_matrix_values();
+    setup_tree();
+    if (matrix()->nnz() != nnz) {
+      std::cerr << "ERROR: the sparsity pattern of the matrix does"
+                << " not match the pattern in " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    try {
+      tree()->root()->read_factors(is);
+    } catch (std::exception& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    factored_ = true;
+    if (opts_.verbose() && is_root_)
+      std::cout << "# factors read from " << fname
+                << ", factor nonzeros = "
+                << number_format_with_commas(this->factor_nonzeros())
+                << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   StrumpackSparseSolver<scalar_t,integer_t>::solve_internal
   (const scalar_t* b, scalar_t* x, bool use_initial_guess) {
@@ -228,19 +530,50 @@ namespace strumpack {
         DenseMW_t X(x.rows(), 1, w, x.ld());
         tree()->multifrontal_solve(X);
       };
+    auto bMFsolve = [&](DenseM_t& w) { tree()->multifrontal_solve(w); };
+    auto bspmv = [&](const DenseM_t& X, DenseM_t& Y)
+                 { matrix()->spmv(X, Y); };
+
+    // for multiple right-hand sides, use the block variants, which
+    // apply the preconditioner to all columns at once
+    auto gmres =
+      [&](const iterative::PREC<scalar_t>& prec,
+          const iterative::BlockPREC<scalar_t>& bprec) {
+        if (x.cols() == 1)
+          iterative::GMRes<scalar_t>
+            (spmv, prec, x.rows(), x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockGMRes<scalar_t>
+            (bspmv, bprec, x, bloc, opts_.rel_tol(), opts_.abs_tol(),
+             Krylov_its_, opts_.maxit(), opts_.gmres_restart(),
+             opts_.GramSchmidt_type(), use_initial_guess,
+             opts_.verbose() && is_root_);
+      };
+    auto bicgstab =
+      [&](const iterative::PREC<scalar_t>& prec,
+          const iterative::BlockPREC<scalar_t>& bprec) {
+        if (x.cols() == 1)
+          iterative::BiCGStab<scalar_t>
+            (spmv, prec, x.rows(), x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockBiCGStab<scalar_t>
+            (bspmv, bprec, x, bloc, opts_.rel_tol(), opts_.abs_tol(),
+             Krylov_its_, opts_.maxit(), use_initial_guess,
+             opts_.verbose() && is_root_);
+      };
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
-        iterative::GMRes<scalar_t>
-          (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-           opts_.gmres_restart(), opts_.GramSchmidt_type(),
-           use_initial_guess, opts_.verbose() && is_root_);
+      if (opts_.compression() != CompressionType::NONE)
+        gmres(MFsolve, bMFsolve);
       else
         iterative::IterativeRefinement<scalar_t,integer_t>
-          (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
-           x, bloc, opts_.rel_tol(), opts_.abs_tol(),
+          (*matrix(), bMFsolve, x, bloc, opts_.rel_tol(), opts_.abs_tol(),
            Krylov_its_, opts_.maxit(), use_initial_guess,
            opts_.verbose() && is_root_);
     }; break;
@@ -250,41 +583,22 @@ namespace strumpack {
     }; break;
     case KrylovSolver::REFINE: {
       iterative::IterativeRefinement<scalar_t,integer_t>
-        (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
-         x, bloc, opts_.rel_tol(), opts_.abs_tol(),
+        (*matrix(), bMFsolve, x, bloc, opts_.rel_tol(), opts_.abs_tol(),
          Krylov_its_, opts_.maxit(), use_initial_guess,
          opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::PREC_GMRES: {
-      assert(x.cols() == 1);
-      iterative::GMRes<scalar_t>
-        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      gmres(MFsolve, bMFsolve);
     }; break;
     case KrylovSolver::PREC_BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<scalar_t>
-        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      bicgstab(MFsolve, bMFsolve);
+    }; break;
+    case KrylovSolver::GMRES: {
+      gmres([](scalar_t*) {}, [](DenseM_t&) {});
     }; break;
-    case KrylovSolver::GMRES: { // see above
-      assert(x.cols() == 1);
-      iterative::GMRes<scalar_t>
-        (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose() && is_root_);
-    }
     case KrylovSolver::BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<scalar_t>
-        (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose() && is_root_);
-    }
+      bicgstab([](scalar_t*) {}, [](DenseM_t&) {});
+    }; break;
     }
 
     if (opts_.matching() == MatchingJob::NONE) {
@@ -305,6 +619,11 @@ namespace strumpack {
     t.stop();
     this->perf_counters_stop("DIRECT/GMRES solve");
     this->print_solve_stats(t);
+    if (tree()->factor_store_failed()) {
+      std::cerr << "# ERROR: reading the out-of-core factors failed"
+                << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
     return ReturnCode::SUCCESS;
   }
 
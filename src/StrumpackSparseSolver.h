@@ -135,7 +135,9 @@ typedef enum
   {
    STRUMPACK_SUCCESS=0,
    STRUMPACK_MATRIX_NOT_SET=1,
-   STRUMPACK_REORDERING_ERROR=2
+   STRUMPACK_REORDERING_ERROR=2,
+   STRUMPACK_FILE_ERROR=3,
+   STRUMPACK_ZERO_PIVOT=4
   } STRUMPACK_RETURN_CODE;
 
 
@@ -204,6 +204,44 @@ namespace strumpack {
      */
     void update_matrix_values(const CSRMatrix<scalar_t,integer_t>& A);
 
+    /**
+     * Write the factorization to a binary file. This includes the
+     * matching and equilibration, the fill-reducing permutation and
+     * separator tree, and the factors and pivots of all fronts. If
+     * the matrix was not yet factored, factor() is called first.
+     *
+     * The file can later be read with load_factors, to solve with
+     * the same matrix without reordering and factoring again. The
+     * file format is binary, native endian, and depends on scalar_t
+     * and integer_t. The factors of each front are aligned to 64
+     * bytes in the file.
+     *
+     * This is only supported without compression, ie, when all
+     * fronts are dense.
+     *
+     * \param fname name of the file to write
+     * \return error code, FILE_ERROR if the file could not be
+     * written
+     * \see load_factors
+     */
+    ReturnCode save_factors(const std::string& fname);
+
+    /**
+     * Read a factorization, written with save_factors, from a binary
+     * file. The matrix (the same one that was used to compute the
+     * factorization) should be set before calling this routine, with
+     * set_matrix or set_csr_matrix, since it is used for iterative
+     * refinement. After this call, the solver can be used to solve
+     * without calling reorder or factor. The matching, factorization
+     * type and compression options are taken from the file.
+     *
+     * \param fname name of the file to read
+     * \return error code, FILE_ERROR if the file could not be read,
+     * or does not match the current matrix
+     * \see save_factors
+     */
+    ReturnCode load_factors(const std::string& fname);
+
   private:
     void setup_tree() override;
     void setup_reordering() override;
@@ -220,6 +258,10 @@ namespace strumpack {
     const Tree_t* tree() const override { return tree_.get(); }
 
     void permute_matrix_values();
+    void setup_value_map
+    (integer_t N, const integer_t* row_ptr, const integer_t* col_ind);
+    bool update_values_from_map
+    (integer_t N, const integer_t* row_ptr, const scalar_t* values);
 
     ReturnCode solve_internal
     (const scalar_t* b, scalar_t* x, bool use_initial_guess=false) override;
@@ -230,6 +272,15 @@ namespace strumpack {
     std::unique_ptr<MatrixReordering<scalar_t,integer_t>> nd_;
     std::unique_ptr<EliminationTree<scalar_t,integer_t>> tree_;
 
+    // for every nonzero of mat_, the index in the values array passed
+    // to update_matrix_values, or -1 for explicit zeros, and the row
+    // and column scaling (empty if not scaled) of mat_, see
+    // SPOptions::enable_assembly_maps. This is stored in addition to
+    // the values in mat_, see setup_value_map.
+    std::vector<integer_t> val_map_;
+    std::vector<typename RealType<scalar_t>::value_type> val_Dr_, val_Dc_;
+    integer_t val_map_nnz_ = 0;
+
     using SPBase_t = StrumpackSparseSolverBase<scalar_t,integer_t>;
     using SPBase_t::opts_;
     using SPBase_t::is_root_;
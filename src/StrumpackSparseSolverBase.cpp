@@ -33,6 +33,7 @@
 
 #include "misc/Tools.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/FrontTrace.hpp"
 #include "StrumpackOptions.hpp"
 #include "sparse/ordering/MatrixReordering.hpp"
 #include "sparse/EliminationTree.hpp"
@@ -89,11 +90,6 @@ namespace strumpack {
                   << " = log_2(#threads) + 3"<< std::endl;
       }
     }
-#if defined(STRUMPACK_COUNT_FLOPS)
-    // if (!params::flops.is_lock_free())
-    //   std::cerr << "# WARNING: the flop counter is not lock free"
-    //             << std::endl;
-#endif
     opts_.HSS_options().set_synchronized_compression(true);
   }
 
@@ -311,6 +307,20 @@ namespace strumpack {
     if (reordered_) return ReturnCode::SUCCESS;
     TaskTimer t1("permute-scale");
     int ierr;
+    // matching and (row/column) equilibration would destroy the
+    // symmetry required by the Cholesky/LDLt factorization
+    bool sym = opts_.symmetric_factorization();
+    if (sym) {
+      if (opts_.matching() != MatchingJob::NONE && is_root_)
+        std::cerr << "# WARNING: matching is not supported with the "
+                  << get_name(opts_.factorization())
+                  << " factorization, disabling it" << std::endl;
+      else if (opts_.verbose() && is_root_)
+        std::cout << "# " << get_name(opts_.factorization())
+                  << " factorization, disabling matching and equilibration"
+                  << std::endl;
+      opts_.set_matching(MatchingJob::NONE);
+    }
     if (opts_.matching() != MatchingJob::NONE) {
       if (opts_.verbose() && is_root_)
         std::cout << "# matching job: " << get_description(opts_.matching())
@@ -323,12 +333,14 @@ namespace strumpack {
       }
     }
 
-    equil_ = matrix()->equilibration();
-    matrix()->equilibrate(equil_);
-    if (opts_.verbose() && is_root_)
-      std::cout << "# matrix equilibration, r_cond = "
-                << equil_.rcond << " , c_cond = " << equil_.ccond
-                << " , type = " << char(equil_.type) << std::endl;
+    if (!sym) {
+      equil_ = matrix()->equilibration();
+      matrix()->equilibrate(equil_);
+      if (opts_.verbose() && is_root_)
+        std::cout << "# matrix equilibration, r_cond = "
+                  << equil_.rcond << " , c_cond = " << equil_.ccond
+                  << " , type = " << char(equil_.type) << std::endl;
+    }
 
     auto old_nnz = matrix()->nnz();
     TaskTimer t2("sparsity-symmetrization",
@@ -387,11 +399,14 @@ namespace strumpack {
           std::cout << "#   - nr of HODLR Frontal matrices = "
                     << number_format_with_commas(fc.HODLR) << std::endl;
           break;
-        case CompressionType::LOSSLESS:
         case CompressionType::LOSSY:
           std::cout << "#   - nr of lossy Frontal matrices = "
                     << number_format_with_commas(fc.lossy) << std::endl;
           break;
+        case CompressionType::LOSSLESS:
+          std::cout << "#   - nr of lossless Frontal matrices = "
+                    << number_format_with_commas(fc.lossless) << std::endl;
+          break;
         case CompressionType::NONE:
         default: break;
         }
@@ -525,13 +540,39 @@ namespace strumpack {
         std::cout << "#   - replacing of small pivots is "
                   << (opts_.replace_tiny_pivots() ? "" : "not")
                   << " enabled" << std::endl;
+        std::cout << "#   - factorization = "
+                  << get_name(opts_.symmetric_factorization() ?
+                              opts_.factorization() : FactorizationType::LU)
+                  << std::endl;
       }
     }
     perf_counters_start();
     flop_breakdown_reset();
+    params::memory.reset_peak();
+    params::device_memory.reset_peak();
+    if (!opts_.trace_file().empty()) FrontTrace::enable();
     TaskTimer t1("Sparse-factorization", [&]() {
         tree()->multifrontal_factorization(*matrix(), opts_);
       });
+    if (!opts_.trace_file().empty()) {
+      FrontTrace::disable();
+      if (!FrontTrace::write(opts_.trace_file()))
+        std::cerr << "# WARNING: could not write the trace file "
+                  << opts_.trace_file() << std::endl;
+    }
+    if (tree()->factor_store_failed()) {
+      if (is_root_)
+        std::cerr << "# ERROR: writing the out-of-core factors failed"
+                  << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (tree()->factor_failed()) {
+      if (is_root_)
+        std::cerr << "# ERROR: the " << get_name(opts_.factorization())
+                  << " factorization failed, the matrix is singular or,"
+                  << " for Cholesky, not positive definite" << std::endl;
+      return ReturnCode::ZERO_PIVOT;
+    }
     perf_counters_stop("numerical factorization");
     if (opts_.verbose()) {
       auto fnnz = factor_nonzeros();
@@ -549,10 +590,10 @@ namespace strumpack {
         std::cout << "#   - factor flop rate = " << ftot_ / t1.elapsed() / 1e9
                   << " GFlop/s" << std::endl;
         std::cout << "#   - factor peak memory usage (estimate) = "
-                  << double(params::peak_memory) / 1.0e6
+                  << double(params::memory.peak()) / 1.0e6
                   << " MB" << std::endl;
         std::cout << "#   - factor peak device memory usage (estimate) = "
-                  << double(params::peak_device_memory)/1.e6
+                  << double(params::device_memory.peak())/1.e6
                   << " MB" << std::endl;
 #endif
         if (opts_.compression() != CompressionType::NONE) {
@@ -268,30 +268,55 @@ namespace strumpack {
       mat_mpi_->spmv(x, y);
     };
 
+    auto bspmv = [&](const DenseM_t& X, DenseM_t& Y) {
+      mat_mpi_->spmv(X, Y);
+    };
+
+    // for multiple right-hand sides, use the block variants, which
+    // apply the preconditioner to all columns at once
     auto gmres =
-      [&](const std::function<void(scalar_t*)>& prec) {
-        assert(x.cols() == 1);
-        iterative::GMResMPI<scalar_t>
-          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
-           opts_.gmres_restart(), opts_.GramSchmidt_type(),
-           use_initial_guess, opts_.verbose() && is_root_);
+      [&](const iterative::PREC<scalar_t>& prec,
+          const iterative::BlockPREC<scalar_t>& bprec) {
+        if (x.cols() == 1)
+          iterative::GMResMPI<scalar_t>
+            (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockGMResMPI<scalar_t>
+            (comm_, bspmv, bprec, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
       };
     auto bicgstab =
-      [&](const std::function<void(scalar_t*)>& prec) {
-        assert(x.cols() == 1);
-        iterative::BiCGStabMPI<scalar_t>
-          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
-           use_initial_guess, opts_.verbose() && is_root_);
+      [&](const iterative::PREC<scalar_t>& prec,
+          const iterative::BlockPREC<scalar_t>& bprec) {
+        if (x.cols() == 1)
+          iterative::BiCGStabMPI<scalar_t>
+            (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockBiCGStabMPI<scalar_t>
+            (comm_, bspmv, bprec, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
       };
     auto MFsolve =
       [&](scalar_t* w) {
         DenseMW_t X(nloc, x.cols(), w, x.ld());
         tree()->multifrontal_solve_dist(X, mat_mpi_->dist());
       };
+    auto bMFsolve =
+      [&](DenseM_t& w) {
+        tree()->multifrontal_solve_dist(w, mat_mpi_->dist());
+      };
     auto refine =
       [&]() {
         iterative::IterativeRefinementMPI<scalar_t,integer_t>
@@ -305,24 +330,24 @@ namespace strumpack {
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
-        gmres(MFsolve);
+      if (opts_.compression() != CompressionType::NONE)
+        gmres(MFsolve, bMFsolve);
       else refine();
     }; break;
     case KrylovSolver::REFINE: {
       refine();
     }; break;
     case KrylovSolver::GMRES: {
-      gmres([](scalar_t*){});
+      gmres([](scalar_t*){}, [](DenseM_t&){});
     }; break;
     case KrylovSolver::PREC_GMRES: {
-      gmres(MFsolve);
+      gmres(MFsolve, bMFsolve);
     }; break;
     case KrylovSolver::BICGSTAB: {
-      bicgstab([](scalar_t*){});
+      bicgstab([](scalar_t*){}, [](DenseM_t&){});
     }; break;
     case KrylovSolver::PREC_BICGSTAB: {
-      bicgstab(MFsolve);
+      bicgstab(MFsolve, bMFsolve);
     }; break;
     case KrylovSolver::DIRECT: {
       // TODO bloc is already a copy, avoid extra copy?
@@ -343,6 +368,12 @@ namespace strumpack {
     t.stop();
     this->perf_counters_stop("DIRECT/GMRES solve");
     this->print_solve_stats(t);
+    if (tree()->factor_store_failed()) {
+      if (is_root_)
+        std::cerr << "# ERROR: reading the out-of-core factors failed"
+                  << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
     return ReturnCode::SUCCESS;
   }
 
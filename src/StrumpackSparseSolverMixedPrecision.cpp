@@ -0,0 +1,247 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ */
+#include <iostream>
+
+#include "StrumpackSparseSolverMixedPrecision.hpp"
+#include "misc/TaskTimer.hpp"
+#include "sparse/iterative/IterativeSolvers.hpp"
+
+namespace strumpack {
+
+  template<typename factor_t,typename refine_t,typename integer_t>
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  StrumpackSparseSolverMixedPrecision
+  (int argc, char* argv[], bool verbose, bool root)
+    : solver_(argc, argv, verbose, root), opts_(argc, argv),
+      is_root_(root) {
+    opts_.set_verbose(verbose);
+    solver_.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t>
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  StrumpackSparseSolverMixedPrecision(bool verbose, bool root)
+    : StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>
+    (0, nullptr, verbose, root) { }
+
+  template<typename factor_t,typename refine_t,typename integer_t> void
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  set_from_options() {
+    opts_.set_from_command_line();
+    solver_.set_from_options();
+    solver_.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> void
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  set_from_options(int argc, char* argv[]) {
+    opts_.set_from_command_line(argc, argv);
+    solver_.set_from_options(argc, argv);
+    solver_.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> void
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
+  set_matrix(const CSRMatrix<refine_t,integer_t>& A) {
+    mat_ = A;
+    std::vector<factor_t> val(A.nnz());
+    for (integer_t i=0; i<A.nnz(); i++)
+      val[i] = static_cast<factor_t>(A.val(i));
+    CSRMatrix<factor_t,integer_t> Af
+      (A.size(), A.ptr(), A.ind(), val.data(), A.symm_sparse());
+    solver_.set_matrix(Af);
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::reorder
+  (int nx, int ny, int nz) {
+    return solver_.reorder(nx, ny, nz);
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::factor() {
+    return solver_.factor();
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::solve
+  (const refine_t* b, refine_t* x, bool use_initial_guess) {
+    auto N = mat_.size();
+    auto B = ConstDenseMatrixWrapperPtr(N, 1, b, N);
+    DenseMatrixWrapper<refine_t> X(N, 1, x, N);
+    return solve(*B, X, use_initial_guess);
+  }
+
+  template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t>::solve
+  (const DenseMR_t& b, DenseMR_t& x, bool use_initial_guess) {
+    TaskTimer t("solve");
+    t.start();
+    assert(b.cols() == x.cols());
+    {
+      // does nothing if already factored
+      ReturnCode ierr = factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    const std::size_t n = mat_.size();
+    // the factor_t solver is called once per outer iteration, keep
+    // it quiet
+    bool solver_verbose = solver_.options().verbose();
+    solver_.options().set_verbose(false);
+    // apply the factor_t solve to a refine_t (block) vector, the
+    // first error returned by the factor_t solver is returned
+    ReturnCode ierr = ReturnCode::SUCCESS;
+    DenseMF_t wf, xf;
+    auto bprec = [&](DenseMR_t& w) {
+      if (wf.rows() != w.rows() || wf.cols() != w.cols()) {
+        wf = DenseMF_t(w.rows(), w.cols());
+        xf = DenseMF_t(w.rows(), w.cols());
+      }
+      for (std::size_t j=0; j<w.cols(); j++)
+        for (std::size_t i=0; i<w.rows(); i++)
+          wf(i, j) = static_cast<factor_t>(w(i, j));
+      auto e = solver_.solve(wf, xf);
+      if (ierr == ReturnCode::SUCCESS) ierr = e;
+      for (std::size_t j=0; j<w.cols(); j++)
+        for (std::size_t i=0; i<w.rows(); i++)
+          w(i, j) = static_cast<refine_t>(xf(i, j));
+    };
+    auto prec = [&](refine_t* w) {
+      DenseMatrixWrapper<refine_t> W(n, 1, w, n);
+      bprec(W);
+    };
+    auto spmv = [&](const refine_t* x, refine_t* y) { mat_.spmv(x, y); };
+    auto bspmv = [&](const DenseMR_t& X, DenseMR_t& Y) { mat_.spmv(X, Y); };
+    auto verbose = opts_.verbose() && is_root_;
+    // solve A X = B with (preconditioned) GMRes or BiCGStab
+    auto Krylov =
+      [&](bool use_gmres, const iterative::PREC<refine_t>& M,
+          const iterative::BlockPREC<refine_t>& bM, DenseMR_t& X,
+          const DenseMR_t& B, bool guess, bool verb) {
+        int its = 0;
+        if (use_gmres) {
+          if (X.cols() == 1)
+            iterative::GMRes<refine_t>
+              (spmv, M, n, X.data(), B.data(), opts_.rel_tol(),
+               opts_.abs_tol(), its, opts_.maxit(), opts_.gmres_restart(),
+               opts_.GramSchmidt_type(), guess, verb);
+          else
+            iterative::BlockGMRes<refine_t>
+              (bspmv, bM, X, B, opts_.rel_tol(), opts_.abs_tol(), its,
+               opts_.maxit(), opts_.gmres_restart(),
+               opts_.GramSchmidt_type(), guess, verb);
+        } else {
+          if (X.cols() == 1)
+            iterative::BiCGStab<refine_t>
+              (spmv, M, n, X.data(), B.data(), opts_.rel_tol(),
+               opts_.abs_tol(), its, opts_.maxit(), guess, verb);
+          else
+            iterative::BlockBiCGStab<refine_t>
+              (bspmv, bM, X, B, opts_.rel_tol(), opts_.abs_tol(), its,
+               opts_.maxit(), guess, verb);
+        }
+        return its;
+      };
+    // The factor_t preconditioner is only accurate up to factor_t
+    // precision, so the preconditioned residual computed by the
+    // Krylov solver cannot be trusted below that. Hence, the
+    // preconditioned Krylov solver is used to compute the correction
+    // in an outer refine_t iterative refinement loop.
+    int inner_its = 0;
+    auto Krylov_refine = [&](bool use_gmres) {
+      auto correction = [&](DenseMR_t& r) {
+        DenseMR_t d(r.rows(), r.cols());
+        d.zero();
+        inner_its += Krylov(use_gmres, prec, bprec, d, r, false, false);
+        r.copy(d);
+      };
+      iterative::IterativeRefinement<refine_t,integer_t>
+        (mat_, correction, x, b, opts_.rel_tol(), opts_.abs_tol(),
+         Krylov_its_, opts_.maxit(), use_initial_guess, verbose);
+    };
+    Krylov_its_ = 0;
+    switch (opts_.Krylov_solver()) {
+    case KrylovSolver::AUTO:
+    case KrylovSolver::REFINE: {
+      iterative::IterativeRefinement<refine_t,integer_t>
+        (mat_, bprec, x, b, opts_.rel_tol(), opts_.abs_tol(),
+         Krylov_its_, opts_.maxit(), use_initial_guess, verbose);
+    }; break;
+    case KrylovSolver::DIRECT: {
+      x.copy(b);
+      bprec(x);
+    }; break;
+    case KrylovSolver::PREC_GMRES: {
+      Krylov_refine(true);
+    }; break;
+    case KrylovSolver::PREC_BICGSTAB: {
+      Krylov_refine(false);
+    }; break;
+    case KrylovSolver::GMRES: {
+      Krylov_its_ = Krylov
+        (true, [](refine_t*) {}, [](DenseMR_t&) {}, x, b,
+         use_initial_guess, verbose);
+    }; break;
+    case KrylovSolver::BICGSTAB: {
+      Krylov_its_ = Krylov
+        (false, [](refine_t*) {}, [](DenseMR_t&) {}, x, b,
+         use_initial_guess, verbose);
+    }; break;
+    }
+    solver_.options().set_verbose(solver_verbose);
+    t.stop();
+    if (verbose) {
+      std::cout << "# mixed precision solve:" << std::endl;
+      std::cout << "#   - abs_tol = " << opts_.abs_tol()
+                << ", rel_tol = " << opts_.rel_tol()
+                << ", maxit = " << opts_.maxit() << std::endl;
+      std::cout << "#   - number of outer iterations = "
+                << Krylov_its_ << std::endl;
+      if (inner_its)
+        std::cout << "#   - number of inner Krylov iterations = "
+                  << inner_its << std::endl;
+      std::cout << "#   - solve time = " << t.elapsed() << std::endl;
+    }
+    return ierr;
+  }
+
+  // explicit template instantiations
+  template class StrumpackSparseSolverMixedPrecision<float,double,int>;
+  template class StrumpackSparseSolverMixedPrecision
+  <std::complex<float>,std::complex<double>,int>;
+
+  template class StrumpackSparseSolverMixedPrecision<float,double,long int>;
+  template class StrumpackSparseSolverMixedPrecision
+  <std::complex<float>,std::complex<double>,long int>;
+
+  template class StrumpackSparseSolverMixedPrecision
+  <float,double,long long int>;
+  template class StrumpackSparseSolverMixedPrecision
+  <std::complex<float>,std::complex<double>,long long int>;
+
+} //end namespace strumpack
@@ -0,0 +1,211 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ */
+/**
+ * \file StrumpackSparseSolverMixedPrecision.hpp
+ * \brief Contains the mixed precision definition of the
+ * sequential/multithreaded sparse solver class.
+ */
+#ifndef STRUMPACK_SPARSE_SOLVER_MIXED_PRECISION_HPP
+#define STRUMPACK_SPARSE_SOLVER_MIXED_PRECISION_HPP
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * \class StrumpackSparseSolverMixedPrecision
+   * \brief StrumpackSparseSolverMixedPrecision uses a lower precision
+   * factorization as a preconditioner for an outer iterative solver
+   * in higher precision.
+   *
+   * The sparse matrix is stored in refine_t precision, and a copy in
+   * factor_t precision is factored with a StrumpackSparseSolver. The
+   * outer solver (iterative refinement, GMRes or BiCGStab, see
+   * SPOptions::set_Krylov_solver) runs in refine_t precision, and
+   * uses the factor_t solve as preconditioner. This halves the
+   * memory for the factors, and the memory traffic in the solve,
+   * compared to a refine_t factorization, while the refinement
+   * recovers refine_t accuracy for well conditioned problems.
+   *
+   * \tparam factor_t precision used for the factorization, float or
+   * std::complex<float>
+   * \tparam refine_t precision used for the outer solver, double or
+   * std::complex<double>
+   * \tparam integer_t integer type, see StrumpackSparseSolver
+   * \see StrumpackSparseSolver
+   */
+  template<typename factor_t,typename refine_t,typename integer_t=int>
+  class StrumpackSparseSolverMixedPrecision {
+
+    using DenseMR_t = DenseMatrix<refine_t>;
+    using DenseMF_t = DenseMatrix<factor_t>;
+
+  public:
+    /**
+     * Constructor, taking command line arguments. The options are
+     * parsed for both the outer solver options (options()) and the
+     * options of the factor_t solver (factor_options()).
+     * \param argc number of arguments, i.e, number of elements in
+     * the argv array
+     * \param argv command line arguments. Add -h or --help to have a
+     * description printed
+     * \param verbose flag to enable/disable output to cout
+     * \param root flag to denote whether this process is the root MPI
+     * process, only the root will print certain messages to cout
+     */
+    StrumpackSparseSolverMixedPrecision
+    (int argc, char* argv[], bool verbose=true, bool root=true);
+
+    /**
+     * Constructor.
+     * \param verbose flag to enable/disable output to cout
+     * \param root flag to denote whether this process is the root MPI
+     * process. Only the root will print certain messages
+     * \see set_from_options
+     */
+    StrumpackSparseSolverMixedPrecision(bool verbose=true, bool root=true);
+
+    /**
+     * Associate a (sequential) CSRMatrix with this solver. The
+     * matrix is copied, and a factor_t copy is passed to the
+     * factor_t solver.
+     * \param A the sparse matrix, in refine_t precision
+     */
+    void set_matrix(const CSRMatrix<refine_t,integer_t>& A);
+
+    /**
+     * Compute matching, scaling and fill-reducing reordering, see
+     * StrumpackSparseSolverBase::reorder.
+     */
+    ReturnCode reorder(int nx=1, int ny=1, int nz=1);
+
+    /**
+     * Perform the numerical factorization, in factor_t precision.
+     */
+    ReturnCode factor();
+
+    /**
+     * Solve a linear system with a single right-hand side, using
+     * the outer solver selected in options(). With
+     * KrylovSolver::AUTO, this is iterative refinement.
+     * \param b input, will not be modified. Pointer to the right-hand
+     * side. Array should be lenght N, the dimension of the input
+     * matrix.
+     * \param x Output, pointer to the solution vector. Array should
+     * be lenght N, the dimension of the input matrix.
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code
+     */
+    ReturnCode solve(const refine_t* b, refine_t* x,
+                     bool use_initial_guess=false);
+
+    /**
+     * Solve a linear system with one or more right-hand sides, see
+     * solve(const refine_t*, refine_t*, bool).
+     * \param b input, will not be modified. The right-hand side(s),
+     * N x nrhs
+     * \param x output, the solution(s), N x nrhs, should be
+     * allocated
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code
+     */
+    ReturnCode solve(const DenseMR_t& b, DenseMR_t& x,
+                     bool use_initial_guess=false);
+
+    /**
+     * Parse the command line options that were passed to the
+     * constructor, for both options() and factor_options().
+     */
+    void set_from_options();
+
+    /**
+     * Parse command line options, for both options() and
+     * factor_options().
+     */
+    void set_from_options(int argc, char* argv[]);
+
+    /**
+     * Options for the outer, refine_t precision, solver. This sets
+     * the outer solver type, tolerances and maximum number of
+     * iterations.
+     */
+    SPOptions<refine_t>& options() { return opts_; }
+    /**
+     * Options for the outer, refine_t precision, solver.
+     */
+    const SPOptions<refine_t>& options() const { return opts_; }
+
+    /**
+     * Options for the factor_t precision solver. These control the
+     * reordering, factorization and compression. The Krylov solver
+     * of the factor_t solver is always KrylovSolver::DIRECT.
+     */
+    SPOptions<factor_t>& factor_options() { return solver_.options(); }
+    /**
+     * Options for the factor_t precision solver.
+     */
+    const SPOptions<factor_t>& factor_options() const {
+      return solver_.options();
+    }
+
+    /**
+     * Access the factor_t precision solver.
+     */
+    StrumpackSparseSolver<factor_t,integer_t>& solver() { return solver_; }
+    /**
+     * Access the factor_t precision solver.
+     */
+    const StrumpackSparseSolver<factor_t,integer_t>& solver() const {
+      return solver_;
+    }
+
+    /**
+     * Number of iterations of the outer solver in the last call to
+     * solve.
+     */
+    int Krylov_iterations() const { return Krylov_its_; }
+
+  private:
+    CSRMatrix<refine_t,integer_t> mat_;
+    StrumpackSparseSolver<factor_t,integer_t> solver_;
+    SPOptions<refine_t> opts_;
+    bool is_root_;
+    int Krylov_its_ = 0;
+  };
+
+} //end namespace strumpack
+
+#endif // STRUMPACK_SPARSE_SOLVER_MIXED_PRECISION_HPP
@@ -163,23 +163,34 @@ namespace strumpack {
     fs << "];" << std::endl << std::endl;
   }
 
+  // real matrices are filled in one call, which lets counter based
+  // generators produce whole blocks at once
+  template<typename real_t> void random_fill
+  (random::RandomGeneratorBase<real_t>& rgen,
+   std::size_t m, std::size_t n, real_t* A, std::size_t ld) {
+    rgen.fill(m, n, A, ld);
+  }
+  template<typename real_t> void random_fill
+  (random::RandomGeneratorBase<real_t>& rgen,
+   std::size_t m, std::size_t n, std::complex<real_t>* A, std::size_t ld) {
+    for (std::size_t j=0; j<n; j++)
+      for (std::size_t i=0; i<m; i++)
+        A[i+j*ld] = rgen.get();
+  }
+
   template<typename scalar_t> void
   DenseMatrix<scalar_t>::random
   (random::RandomGeneratorBase<typename RealType<scalar_t>::
    value_type>& rgen) {
     TIMER_TIME(TaskType::RANDOM_GENERATE, 1, t_gen);
-    for (std::size_t j=0; j<cols(); j++)
-      for (std::size_t i=0; i<rows(); i++)
-        operator()(i,j) = rgen.get();
+    random_fill(rgen, rows(), cols(), data(), ld());
     STRUMPACK_FLOPS(rgen.flops_per_prng()*cols()*rows());
   }
 
   template<typename scalar_t> void DenseMatrix<scalar_t>::random() {
     TIMER_TIME(TaskType::RANDOM_GENERATE, 1, t_gen);
     auto rgen = random::make_default_random_generator<real_t>();
-    for (std::size_t j=0; j<cols(); j++)
-      for (std::size_t i=0; i<rows(); i++)
-        operator()(i,j) = rgen->get();
+    random_fill(*rgen, rows(), cols(), data(), ld());
     STRUMPACK_FLOPS(rgen->flops_per_prng()*cols()*rows());
   }
 
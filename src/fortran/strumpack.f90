@@ -140,9 +140,12 @@ module strumpack
   enumerator :: STRUMPACK_SUCCESS = 0
   enumerator :: STRUMPACK_MATRIX_NOT_SET = 1
   enumerator :: STRUMPACK_REORDERING_ERROR = 2
+  enumerator :: STRUMPACK_FILE_ERROR = 3
+  enumerator :: STRUMPACK_ZERO_PIVOT = 4
  end enum
  integer, parameter, public :: STRUMPACK_RETURN_CODE = kind(STRUMPACK_SUCCESS)
- public :: STRUMPACK_SUCCESS, STRUMPACK_MATRIX_NOT_SET, STRUMPACK_REORDERING_ERROR
+ public :: STRUMPACK_SUCCESS, STRUMPACK_MATRIX_NOT_SET, STRUMPACK_REORDERING_ERROR, &
+    STRUMPACK_FILE_ERROR, STRUMPACK_ZERO_PIVOT
  public :: STRUMPACK_init_mt
  public :: STRUMPACK_destroy
  public :: STRUMPACK_set_csr_matrix
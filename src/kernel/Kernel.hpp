@@ -36,6 +36,9 @@
 #ifndef STRUMPACK_KERNEL_HPP
 #define STRUMPACK_KERNEL_HPP
 
+#include <limits>
+#include <typeinfo>
+
 #include "Metrics.hpp"
 #include "HSS/HSSOptions.hpp"
 #include "dense/DenseMatrix.hpp"
@@ -139,11 +142,7 @@ namespace strumpack {
                       const std::vector<std::size_t>& J,
                       DenseMatrix<real_t>& B) const {
         assert(B.rows() == I.size() && B.cols() == J.size());
-        for (std::size_t j=0; j<J.size(); j++)
-          for (std::size_t i=0; i<I.size(); i++) {
-            assert(I[i] < n() && J[j] < n());
-            B(i, j) = eval(I[i], J[j]);
-          }
+        eval_block(I, J, B);
       }
 
       /**
@@ -161,6 +160,27 @@ namespace strumpack {
                       const std::vector<std::size_t>& J,
                       DenseMatrix<std::complex<real_t>>& B) const {
         assert(B.rows() == I.size() && B.cols() == J.size());
+        DenseM_t Br(I.size(), J.size());
+        eval_block(I, J, Br);
+        for (std::size_t j=0; j<J.size(); j++)
+          for (std::size_t i=0; i<I.size(); i++)
+            B(i, j) = Br(i, j);
+      }
+
+      /**
+       * Evaluate the submatrix K(I,J), including the regularization
+       * on the diagonal. The default implementation calls eval for
+       * every entry, so kernels which only override eval are used as
+       * is. The built-in kernels override this with eval_panels_if.
+       *
+       * \param I set of row indices of elements to extract
+       * \param J set of col indices of elements to extract
+       * \param B B will be set to K(I,J), should be I.size() x
+       * J.size()
+       */
+      virtual void eval_block(const std::vector<std::size_t>& I,
+                              const std::vector<std::size_t>& J,
+                              DenseM_t& B) const {
         for (std::size_t j=0; j<J.size(); j++)
           for (std::size_t i=0; i<I.size(); i++) {
             assert(I[i] < n() && J[j] < n());
@@ -168,6 +188,37 @@ namespace strumpack {
           }
       }
 
+      /**
+       * Evaluate the kernel function for all pairs of points from
+       * the columns of X and Y, K(i,j) = k(X(:,i), Y(:,j)). The
+       * regularization parameter lambda is not added. The default
+       * implementation calls eval_kernel_function for every pair,
+       * subclasses can override this with a blocked implementation.
+       *
+       * \param X points, X.rows() == this->d()
+       * \param Y points, Y.rows() == this->d()
+       * \param K output, should be X.cols() x Y.cols()
+       */
+      virtual void eval_kernel_block
+      (const DenseM_t& X, const DenseM_t& Y, DenseM_t& K) const {
+        assert(X.rows() == d() && Y.rows() == d());
+        assert(K.rows() == X.cols() && K.cols() == Y.cols());
+        for (std::size_t j=0; j<Y.cols(); j++)
+          for (std::size_t i=0; i<X.cols(); i++)
+            K(i, j) = eval_kernel_function(X.ptr(0, i), Y.ptr(0, j));
+      }
+
+      /**
+       * Upper bound for the absolute value of the kernel function
+       * k(x,y), for all points x and y with (Euclidean) distance
+       * larger than dist. This is used to skip far away groups of
+       * points in predict. The default implementation returns the
+       * largest real_t value, i.e., nothing will be skipped.
+       */
+      virtual real_t far_field_bound(real_t dist) const {
+        return std::numeric_limits<real_t>::max();
+      }
+
       /**
        * Compute weights for kernel ridge regression
        * classification. This will build an approximate HSS
@@ -193,15 +244,29 @@ namespace strumpack {
        * Return prediction scores for the test points, using the
        * weights computed in fit_HSS() or fit_HODLR().
        *
+       * The test and training points are processed in blocks, the
+       * kernel is evaluated for a block of training points and a
+       * block of test points at once with eval_kernel_block, and
+       * multiplied with the weights. If trunc_tol > 0, a block of
+       * training points is skipped for a block of test points when
+       * its contribution is guaranteed to be smaller than trunc_tol,
+       * according to far_field_bound. Since the training data are
+       * permuted according to the HSS clustering in fit_HSS,
+       * consecutive training points are close together, which makes
+       * this truncation effective for fast decaying kernels.
+       *
        * \param test Test data set, should be test.rows() == this->d()
        * \param weights Weights computed by fit_HSS() or fit_HODLR()
+       * \param trunc_tol Far field truncation tolerance, 0 (the
+       * default) disables truncation.
        * \return Vector with prediction scores. One can use the sign
        * (threshold zero), to decide which of 2 classes each test
        * point belongs to.
        * \see fit_HSS, fit_HODLR
        */
       std::vector<scalar_t> predict
-      (const DenseM_t& test, const DenseM_t& weights) const;
+      (const DenseM_t& test, const DenseM_t& weights,
+       real_t trunc_tol=0) const;
 
 #if defined(STRUMPACK_USE_MPI)
       /**
@@ -234,13 +299,17 @@ namespace strumpack {
        *
        * \param test Test data set, should be test.rows() == this->d()
        * \param weights Weights computed by fit_HSS() or fit_HODLR()
+       * \param trunc_tol Far field truncation tolerance, 0 (the
+       * default) disables truncation, see predict(const DenseM_t&,
+       * const DenseM_t&, real_t).
        * \return Vector with prediction scores. One can use the sign
        * (threshold zero), to decide which of 2 classes each test
        * point belongs to.
        * \see fit_HSS, fit_HODLR
        */
       std::vector<scalar_t> predict
-      (const DenseM_t& test, const DistM_t& weights) const;
+      (const DenseM_t& test, const DistM_t& weights,
+       real_t trunc_tol=0) const;
 
 #if defined(STRUMPACK_USE_BPACK)
       /**
@@ -307,6 +376,52 @@ namespace strumpack {
        */
       virtual scalar_t eval_kernel_function
       (const scalar_t* x, const scalar_t* y) const = 0;
+
+      /**
+       * Evaluate the submatrix K(I,J), including the regularization
+       * on the diagonal, with eval_kernel_block. The points in I and
+       * J are copied to contiguous panels and evaluated at once.
+       */
+      void eval_panels(const std::vector<std::size_t>& I,
+                       const std::vector<std::size_t>& J,
+                       DenseM_t& B) const {
+        const std::size_t nI = I.size(), nJ = J.size();
+        if (!nI || !nJ) return;
+        DenseM_t X(d(), nI), Y(d(), nJ);
+        for (std::size_t i=0; i<nI; i++) {
+          assert(I[i] < n());
+          std::copy(data_.ptr(0, I[i]), data_.ptr(0, I[i])+d(), X.ptr(0, i));
+        }
+        for (std::size_t j=0; j<nJ; j++) {
+          assert(J[j] < n());
+          std::copy(data_.ptr(0, J[j]), data_.ptr(0, J[j])+d(), Y.ptr(0, j));
+        }
+        eval_kernel_block(X, Y, B);
+        if (lambda_ != scalar_t(0.))
+          for (std::size_t j=0; j<nJ; j++)
+            for (std::size_t i=0; i<nI; i++)
+              if (I[i] == J[j]) B(i, j) += lambda_;
+      }
+
+      /**
+       * Use eval_panels if this is exactly a kernel of type K, and
+       * not a subclass of K which might override eval.
+       */
+      template<typename K> void
+      eval_panels_if(const std::vector<std::size_t>& I,
+                     const std::vector<std::size_t>& J,
+                     DenseM_t& B) const {
+        if (typeid(*this) == typeid(K)) eval_panels(I, J, B);
+        else Kernel<scalar_t>::eval_block(I, J, B);
+      }
+
+      /**
+       * Add the contributions of the training points X, with weights
+       * w, to the prediction for the test points.
+       */
+      void predict_local
+      (const DenseM_t& test, const DenseM_t& X, const scalar_t* w,
+       real_t trunc_tol, std::vector<scalar_t>& prediction) const;
     };
 
 
@@ -343,6 +458,70 @@ namespace strumpack {
       GaussKernel(DenseMatrix<scalar_t>& data, scalar_t h, scalar_t lambda)
         : Kernel<scalar_t>(data, lambda), h_(h) {}
 
+      void eval_block(const std::vector<std::size_t>& I,
+                      const std::vector<std::size_t>& J,
+                      DenseMatrix<scalar_t>& B) const override {
+        this->template eval_panels_if<GaussKernel<scalar_t>>(I, J, B);
+      }
+
+      /**
+       * Evaluate the kernel for all pairs of points in X and Y. The
+       * squared distances are computed as ||x||^2 + ||y||^2 - 2
+       * x^T y, using a single GEMM for the x^T y part. The points
+       * are first shifted by their mean, which keeps the norms, and
+       * hence the cancellation error, small. Distances which are
+       * still small compared to the norms are recomputed directly.
+       */
+      void eval_kernel_block
+      (const DenseMatrix<scalar_t>& X, const DenseMatrix<scalar_t>& Y,
+       DenseMatrix<scalar_t>& K) const override {
+        const std::size_t m = X.cols(), n = Y.cols(), d = this->d();
+        std::vector<scalar_t> c(d, scalar_t(0.));
+        for (std::size_t i=0; i<m+n; i++) {
+          auto x = (i < m) ? X.ptr(0, i) : Y.ptr(0, i-m);
+          for (std::size_t k=0; k<d; k++) c[k] += x[k];
+        }
+        for (std::size_t k=0; k<d; k++) c[k] /= scalar_t(m+n);
+        DenseMatrix<scalar_t> Xc(d, m), Yc(d, n);
+        std::vector<scalar_t> nxy(m+n);
+        for (std::size_t i=0; i<m+n; i++) {
+          auto x = (i < m) ? X.ptr(0, i) : Y.ptr(0, i-m);
+          auto xc = (i < m) ? Xc.ptr(0, i) : Yc.ptr(0, i-m);
+          scalar_t nrm(0.);
+          for (std::size_t k=0; k<d; k++) {
+            xc[k] = x[k] - c[k];
+            nrm += xc[k] * xc[k];
+          }
+          nxy[i] = nrm;
+        }
+        gemm(Trans::T, Trans::N, scalar_t(-2.), Xc, Yc, scalar_t(0.), K,
+             params::task_recursion_cutoff_level);
+        // below this fraction of ||x||^2 + ||y||^2, the relative
+        // error in the squared distance can exceed sqrt(eps)
+        const scalar_t tol =
+          std::sqrt(std::numeric_limits<scalar_t>::epsilon());
+        const scalar_t s = scalar_t(-1.) / (scalar_t(2.) * h_ * h_);
+        const scalar_t* nx = nxy.data();
+        for (std::size_t j=0; j<n; j++) {
+          auto Kj = K.ptr(0, j);
+          const auto nyj = nxy[m+j];
+#pragma omp simd
+          for (std::size_t i=0; i<m; i++)
+            Kj[i] += nx[i] + nyj;
+          for (std::size_t i=0; i<m; i++)
+            if (Kj[i] <= tol * (nx[i] + nyj))
+              Kj[i] = Euclidean_distance_squared
+                (d, X.ptr(0, i), Y.ptr(0, j));
+#pragma omp simd
+          for (std::size_t i=0; i<m; i++)
+            Kj[i] = std::exp(Kj[i] * s);
+        }
+      }
+
+      scalar_t far_field_bound(scalar_t dist) const override {
+        return std::exp(-dist * dist / (scalar_t(2.) * h_ * h_));
+      }
+
     protected:
       scalar_t h_; // kernel width parameter
 
@@ -388,6 +567,44 @@ namespace strumpack {
       LaplaceKernel(DenseMatrix<scalar_t>& data, scalar_t h, scalar_t lambda)
         : Kernel<scalar_t>(data, lambda), h_(h) {}
 
+      void eval_block(const std::vector<std::size_t>& I,
+                      const std::vector<std::size_t>& J,
+                      DenseMatrix<scalar_t>& B) const override {
+        this->template eval_panels_if<LaplaceKernel<scalar_t>>(I, J, B);
+      }
+
+      /**
+       * Evaluate the kernel for all pairs of points in X and Y. X is
+       * transposed first, so that the inner loop, over the points in
+       * X, has unit stride and can be vectorized.
+       */
+      void eval_kernel_block
+      (const DenseMatrix<scalar_t>& X, const DenseMatrix<scalar_t>& Y,
+       DenseMatrix<scalar_t>& K) const override {
+        const std::size_t m = X.cols(), n = Y.cols(), d = this->d();
+        DenseMatrix<scalar_t> Xt(X.transpose());
+        const scalar_t s = scalar_t(-1.) / h_;
+        for (std::size_t j=0; j<n; j++) {
+          auto Kj = K.ptr(0, j);
+          std::fill(Kj, Kj+m, scalar_t(0.));
+          for (std::size_t k=0; k<d; k++) {
+            const auto ykj = Y(k, j);
+            const auto Xk = Xt.ptr(0, k);
+#pragma omp simd
+            for (std::size_t i=0; i<m; i++)
+              Kj[i] += std::abs(Xk[i] - ykj);
+          }
+#pragma omp simd
+          for (std::size_t i=0; i<m; i++)
+            Kj[i] = std::exp(Kj[i] * s);
+        }
+      }
+
+      scalar_t far_field_bound(scalar_t dist) const override {
+        // the 1-norm distance is at least the 2-norm distance
+        return std::exp(-dist / h_);
+      }
+
     protected:
       scalar_t h_; // kernel width parameter
 
@@ -438,6 +655,61 @@ namespace strumpack {
         assert(p >= 1 && p <= int(this->d()));
       }
 
+      void eval_block(const std::vector<std::size_t>& I,
+                      const std::vector<std::size_t>& J,
+                      DenseMatrix<scalar_t>& B) const override {
+        this->template eval_panels_if<ANOVAKernel<scalar_t>>(I, J, B);
+      }
+
+      /**
+       * Evaluate the kernel for all pairs of points in X and Y. This
+       * uses the same recurrence as eval_kernel_function, with one
+       * exp per feature and pair of points, but vectorized over the
+       * points in X, which are transposed first for unit stride
+       * access.
+       */
+      void eval_kernel_block
+      (const DenseMatrix<scalar_t>& X, const DenseMatrix<scalar_t>& Y,
+       DenseMatrix<scalar_t>& K) const override {
+        const std::size_t m = X.cols(), n = Y.cols(), d = this->d();
+        DenseMatrix<scalar_t> Xt(X.transpose()), Kss(m, p_);
+        std::vector<scalar_t> Kpp(p_+1), e(m), Ks(m);
+        const scalar_t s = scalar_t(-1.) / (scalar_t(2.) * h_ * h_);
+        for (std::size_t j=0; j<n; j++) {
+          Kss.zero();
+          for (std::size_t k=0; k<d; k++) {
+            const auto ykj = Y(k, j);
+            const auto Xk = Xt.ptr(0, k);
+            auto K0 = Kss.ptr(0, 0);
+#pragma omp simd
+            for (std::size_t i=0; i<m; i++) {
+              auto xy = Xk[i] - ykj;
+              e[i] = Ks[i] = std::exp(xy * xy * s);
+              K0[i] += e[i];
+            }
+            // powers of the 1d kernel
+            for (int q=1; q<p_; q++) {
+              auto Kq = Kss.ptr(0, q);
+#pragma omp simd
+              for (std::size_t i=0; i<m; i++) {
+                Ks[i] *= e[i];
+                Kq[i] += Ks[i];
+              }
+            }
+          }
+          for (std::size_t i=0; i<m; i++) {
+            Kpp[0] = 1;
+            for (int q=1; q<=p_; q++) {
+              Kpp[q] = 0;
+              for (int t=1; t<=q; t++)
+                Kpp[q] += std::pow(-1,t+1)*Kpp[q-t]*Kss(i, t-1);
+              Kpp[q] /= q;
+            }
+            K(i, j) = Kpp[p_];
+          }
+        }
+      }
+
     protected:
       scalar_t h_; // kernel width parameter
       int p_;      // kernel degree parameter 1 <= p_ <= this->d()
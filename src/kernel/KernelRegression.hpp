@@ -109,16 +109,77 @@ namespace strumpack {
       return weights;
     }
 
+    template<typename scalar_t> void Kernel<scalar_t>::predict_local
+    (const DenseM_t& test, const DenseM_t& X, const scalar_t* w,
+     real_t trunc_tol, std::vector<scalar_t>& prediction) const {
+      const std::size_t B = 256, m = test.cols(), nx = X.cols();
+      if (!m || !nx) return;
+      const std::size_t nbx = (nx + B - 1) / B, nbt = (m + B - 1) / B;
+      // for each block of training points: a bounding ball (center
+      // and radius) and the sum of the absolute values of the weights
+      DenseM_t cx;
+      std::vector<real_t> rx, wx;
+      auto ball = [&](const DenseM_t& P, std::size_t c0, std::size_t nc,
+                      scalar_t* c) -> real_t {
+        std::fill(c, c+d(), scalar_t(0.));
+        for (std::size_t j=c0; j<c0+nc; j++)
+          for (std::size_t k=0; k<d(); k++)
+            c[k] += P(k, j);
+        for (std::size_t k=0; k<d(); k++)
+          c[k] /= nc;
+        real_t r(0.);
+        for (std::size_t j=c0; j<c0+nc; j++)
+          r = std::max(r, Euclidean_distance(d(), c, P.ptr(0, j)));
+        return r;
+      };
+      if (trunc_tol > 0) {
+        cx = DenseM_t(d(), nbx);
+        rx.resize(nbx);
+        wx.resize(nbx);
+#pragma omp parallel for
+        for (std::size_t b=0; b<nbx; b++) {
+          auto c0 = b*B, nc = std::min(B, nx-c0);
+          rx[b] = ball(X, c0, nc, cx.ptr(0, b));
+          real_t ws(0.);
+          for (std::size_t j=c0; j<c0+nc; j++) ws += std::abs(w[j]);
+          wx[b] = ws;
+        }
+      }
+#pragma omp parallel for schedule(dynamic)
+      for (std::size_t bt=0; bt<nbt; bt++) {
+        auto t0 = bt*B, mt = std::min(B, m-t0);
+        DenseMW_t Y(d(), mt, const_cast<scalar_t*>(test.ptr(0, t0)),
+                    test.ld());
+        DenseM_t K(B, mt), ct;
+        real_t rt(0.);
+        if (trunc_tol > 0) {
+          ct = DenseM_t(d(), 1);
+          rt = ball(test, t0, mt, ct.data());
+        }
+        for (std::size_t bx=0; bx<nbx; bx++) {
+          auto x0 = bx*B, mx = std::min(B, nx-x0);
+          if (trunc_tol > 0) {
+            auto dist = Euclidean_distance(d(), ct.data(), cx.ptr(0, bx))
+              - rt - rx[bx];
+            if (dist > 0 && far_field_bound(dist) * wx[bx] <= trunc_tol)
+              continue;
+          }
+          DenseMW_t Xb(d(), mx, const_cast<scalar_t*>(X.ptr(0, x0)), X.ld());
+          DenseMW_t Kb(mx, mt, K, 0, 0);
+          eval_kernel_block(Xb, Y, Kb);
+          gemv(Trans::T, scalar_t(1.), Kb, w+x0, 1, scalar_t(1.),
+               prediction.data()+t0, 1, params::task_recursion_cutoff_level);
+        }
+      }
+    }
+
     template<typename scalar_t>
     std::vector<scalar_t> Kernel<scalar_t>::predict
-    (const DenseM_t& test, const DenseM_t& weights) const {
+    (const DenseM_t& test, const DenseM_t& weights,
+     real_t trunc_tol) const {
       assert(test.rows() == d());
       std::vector<scalar_t> prediction(test.cols());
-#pragma omp parallel for
-      for (std::size_t c=0; c<test.cols(); c++)
-        for (std::size_t r=0; r<n(); r++)
-          prediction[c] += weights(r, 0) *
-            eval_kernel_function(data_.ptr(0, r), test.ptr(0, c));
+      predict_local(test, data_, weights.data(), trunc_tol, prediction);
       return prediction;
     }
 
@@ -191,16 +252,17 @@ namespace strumpack {
 
     template<typename scalar_t>
     std::vector<scalar_t> Kernel<scalar_t>::predict
-    (const DenseM_t& test, const DistM_t& weights) const {
+    (const DenseM_t& test, const DistM_t& weights,
+     real_t trunc_tol) const {
       std::vector<scalar_t> prediction(test.cols());
       if (weights.active() && weights.lcols()) {
-#pragma omp parallel for
-        for (std::size_t c=0; c<test.cols(); c++)
-          for (int r=0; r<weights.lrows(); r++) {
-            prediction[c] += weights(r, 0) *
-              eval_kernel_function
-              (data_.ptr(0, weights.rowl2g(r)), test.ptr(0, c));
-          }
+        // gather the training points for the local weights
+        const auto lrows = weights.lrows();
+        DenseM_t X(d(), lrows);
+        for (int r=0; r<lrows; r++)
+          std::copy(data_.ptr(0, weights.rowl2g(r)),
+                    data_.ptr(0, weights.rowl2g(r))+d(), X.ptr(0, r));
+        predict_local(test, X, weights.data(), trunc_tol, prediction);
       }
       // reduce the local sums to the global vector
       weights.Comm().all_reduce
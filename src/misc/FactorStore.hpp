@@ -0,0 +1,321 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file FactorStore.hpp
+ * \brief File backed storage for out-of-core factors.
+ */
+#ifndef STRUMPACK_FACTOR_STORE_HPP
+#define STRUMPACK_FACTOR_STORE_HPP
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+
+namespace strumpack {
+
+  /**
+   * \class FactorStore
+   * \brief Stores blocks of factors in a temporary file.
+   *
+   * Writes and reads are queued and handled in order by a single I/O
+   * thread, so that they overlap with the computations. A write
+   * reserves the location of the block in the file immediately, and
+   * returns without waiting for the data to be written, the data is
+   * handed over to the store until it is written, after which a
+   * callback can release it. The size of the queued writes is
+   * bounded, a write waits when the limit is reached. Reads issued
+   * ahead of time, following the traversal of the elimination tree
+   * in the solve, overlap with the computations. The file is removed
+   * when the store is destroyed.
+   *
+   * Errors do not throw (write is called from OpenMP tasks), they
+   * are recorded and can be checked with failed, after wait.
+   *
+   * \tparam T type of the elements, should be trivial
+   */
+  template<typename T> class FactorStore {
+  public:
+    /**
+     * Location of a block in the file.
+     */
+    struct Record {
+      std::size_t offset = 0;
+      std::size_t size = 0;
+    };
+
+    /**
+     * Create a new store, backed by a new file in directory dir. If
+     * dir is empty, the TMPDIR environment variable is used, or the
+     * current directory if TMPDIR is not set. This throws if the file
+     * cannot be created.
+     *
+     * \param max_prefetch maximum number of reads that can be
+     * pending before prefetch_allowed returns false
+     * \param max_write_bytes maximum size of the queued writes, a
+     * write waits when this would be exceeded (unless the queue is
+     * empty)
+     */
+    FactorStore(const std::string& dir="", std::size_t max_prefetch=4,
+                std::size_t max_write_bytes=std::size_t(1) << 28)
+      : max_prefetch_(max_prefetch),
+        max_write_(std::max(std::size_t(1), max_write_bytes / sizeof(T))) {
+      std::string d(dir);
+      if (d.empty()) {
+        auto tmp = std::getenv("TMPDIR");
+        d = tmp ? tmp : ".";
+      }
+      std::random_device rd;
+      std::ostringstream name;
+      name << d << "/strumpack_factors_" << std::hex << rd() << rd();
+      fname_ = name.str();
+      f_.open(fname_, std::ios::out | std::ios::trunc | std::ios::binary);
+      if (f_) {
+        // unbuffered, reads always go to the file
+        rf_.rdbuf()->pubsetbuf(nullptr, 0);
+        rf_.open(fname_, std::ios::in | std::ios::binary);
+      }
+      if (!f_ || !rf_) {
+        f_.close();
+        std::remove(fname_.c_str());
+        throw std::runtime_error
+          ("Could not open out-of-core factor file " + fname_);
+      }
+      io_ = std::thread([this]() { serve(); });
+    }
+
+    FactorStore(const FactorStore&) = delete;
+    FactorStore& operator=(const FactorStore&) = delete;
+
+    /**
+     * Waits for all pending writes and reads, and removes the file.
+     */
+    ~FactorStore() {
+      {
+        std::lock_guard<std::mutex> lock(qm_);
+        stop_ = true;
+      }
+      cv_.notify_one();
+      io_.join();
+      f_.close();
+      rf_.close();
+      std::remove(fname_.c_str());
+    }
+
+    /**
+     * Queue a write of n elements from data to the file. This can be
+     * called concurrently from different threads. The data should
+     * not be modified or freed until release is called, from the I/O
+     * thread, after the data has been written. If the write fails,
+     * release is not called, the store is marked as failed and the
+     * data remains owned by the caller.
+     *
+     * \param r the record to be passed to read, set immediately
+     * \param release called once the data is no longer needed
+     * \return false if the store already failed, then nothing is
+     * queued
+     */
+    bool write(const T* data, std::size_t n, Record& r,
+               std::function<void()> release) {
+      if (failed_) return false;
+      Request q;
+      q.write = true;
+      q.wdata = data;
+      q.release = std::move(release);
+      {
+        std::unique_lock<std::mutex> lock(qm_);
+        wcv_.wait(lock, [&]() {
+            return queued_write_ == 0 || queued_write_ + n <= max_write_; });
+        r.offset = end_;
+        r.size = n;
+        end_ += n;
+        q.r = r;
+        queued_write_ += n;
+        queue_.push_back(std::move(q));
+      }
+      cv_.notify_one();
+      return true;
+    }
+
+    /**
+     * Queue a read of the block described by r into data, which
+     * should have space for at least r.size elements. The data
+     * should not be used (or freed) before the returned future is
+     * ready. If the read fails, the future is still made ready, but
+     * the store is marked as failed.
+     */
+    std::future<void> read(const Record& r, T* data) {
+      Request q;
+      q.r = r;
+      q.data = data;
+      auto fut = q.done.get_future();
+      {
+        std::lock_guard<std::mutex> lock(qm_);
+        queue_.push_back(std::move(q));
+        pending_++;
+      }
+      cv_.notify_one();
+      return fut;
+    }
+
+    /**
+     * Wait until all queued writes and reads are done, and the
+     * written data is flushed to the file.
+     */
+    void wait() {
+      std::unique_lock<std::mutex> lock(qm_);
+      idle_cv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+    }
+
+    /**
+     * Whether a read ahead of time should be queued: false when
+     * max_prefetch reads are already pending. This limits the
+     * memory taken by prefetched blocks, and keeps blocks which are
+     * needed first from waiting behind many reads issued earlier.
+     */
+    bool prefetch_allowed() const {
+      std::lock_guard<std::mutex> lock(qm_);
+      return pending_ < max_prefetch_;
+    }
+
+    /**
+     * Whether a write or a read has failed.
+     */
+    bool failed() const { return failed_; }
+
+    /**
+     * Total number of elements written, or queued to be written, to
+     * the file.
+     */
+    std::size_t size() const {
+      std::lock_guard<std::mutex> lock(qm_);
+      return end_;
+    }
+
+  private:
+    struct Request {
+      bool write = false;
+      Record r;
+      T* data = nullptr;
+      const T* wdata = nullptr;
+      std::function<void()> release;
+      std::promise<void> done;
+    };
+
+    std::string fname_;
+    std::ofstream f_;   // for writes, only used by the I/O thread
+    std::ifstream rf_;  // for reads, only used by the I/O thread
+    bool dirty_ = false; // f_ not flushed, only used by the I/O thread
+    mutable std::mutex qm_;
+    std::condition_variable cv_, wcv_, idle_cv_;
+    std::deque<Request> queue_;
+    std::size_t end_ = 0, pending_ = 0, max_prefetch_,
+      queued_write_ = 0, max_write_;
+    bool stop_ = false, busy_ = false;
+    std::atomic<bool> failed_{false};
+    std::thread io_;
+
+    void serve() {
+      while (true) {
+        Request q;
+        {
+          std::unique_lock<std::mutex> lock(qm_);
+          if (queue_.empty() && dirty_) {
+            // flush once the queue runs empty, not after every write
+            lock.unlock();
+            flush();
+            lock.lock();
+          }
+          if (queue_.empty()) {
+            busy_ = false;
+            idle_cv_.notify_all();
+          }
+          cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+          if (queue_.empty()) return;
+          q = std::move(queue_.front());
+          queue_.pop_front();
+          busy_ = true;
+        }
+        if (q.write) {
+          f_.seekp(q.r.offset * sizeof(T));
+          f_.write(reinterpret_cast<const char*>(q.wdata),
+                   q.r.size * sizeof(T));
+          if (!f_) {
+            f_.clear();
+            failed_ = true;
+          } else {
+            dirty_ = true;
+            if (q.release) q.release();
+          }
+          {
+            std::lock_guard<std::mutex> lock(qm_);
+            queued_write_ -= q.r.size;
+          }
+          wcv_.notify_all();
+        } else {
+          // make the written data visible to the read stream
+          if (dirty_) flush();
+          rf_.seekg(q.r.offset * sizeof(T));
+          rf_.read(reinterpret_cast<char*>(q.data), q.r.size * sizeof(T));
+          if (!rf_) {
+            rf_.clear();
+            failed_ = true;
+          }
+          {
+            std::lock_guard<std::mutex> lock(qm_);
+            pending_--;
+          }
+          q.done.set_value();
+        }
+      }
+    }
+
+    void flush() {
+      f_.flush();
+      if (!f_) {
+        f_.clear();
+        failed_ = true;
+      }
+      dirty_ = false;
+    }
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_FACTOR_STORE_HPP
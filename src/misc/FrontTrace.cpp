@@ -0,0 +1,139 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include "FrontTrace.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "misc/MPIWrapper.hpp"
+#endif
+
+namespace strumpack {
+
+  bool FrontTrace::enabled_ = false;
+  std::chrono::steady_clock::time_point FrontTrace::t_begin_ =
+    std::chrono::steady_clock::now();
+  std::vector<std::vector<FrontTraceEvent>> FrontTrace::thread_events_;
+  std::vector<FrontTraceEvent> FrontTrace::other_events_;
+  std::mutex FrontTrace::other_mtx_;
+
+  std::string get_name(FrontPhase p) {
+    switch (p) {
+    case FrontPhase::ASSEMBLY: return "assembly";
+    case FrontPhase::FACTOR: return "factor";
+    case FrontPhase::EXTEND_ADD: return "extend_add";
+    default: return "unknown";
+    }
+  }
+
+  void FrontTrace::enable() {
+#if defined(_OPENMP)
+    int max_t = omp_get_max_threads();
+#else
+    int max_t = 1;
+#endif
+    thread_events_.clear();
+    thread_events_.resize(max_t);
+    other_events_.clear();
+    t_begin_ = std::chrono::steady_clock::now();
+    enabled_ = true;
+  }
+
+  void FrontTrace::disable() {
+    enabled_ = false;
+  }
+
+  void FrontTrace::record(FrontTraceEvent&& e) {
+    // each thread of the outermost team has its own list, events from
+    // threads in nested parallel regions go to a shared list
+#if defined(_OPENMP)
+    std::size_t t = omp_get_thread_num();
+    if (omp_get_active_level() <= 1 && t < thread_events_.size()) {
+      thread_events_[t].push_back(std::move(e));
+      return;
+    }
+#else
+    if (!thread_events_.empty()) {
+      thread_events_[0].push_back(std::move(e));
+      return;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(other_mtx_);
+    other_events_.push_back(std::move(e));
+  }
+
+  std::vector<FrontTraceEvent> FrontTrace::events() {
+    std::vector<FrontTraceEvent> ev(other_events_);
+    for (auto& te : thread_events_)
+      ev.insert(ev.end(), te.begin(), te.end());
+    std::sort(ev.begin(), ev.end(),
+              [](const FrontTraceEvent& a, const FrontTraceEvent& b) {
+                return a.start < b.start; });
+    return ev;
+  }
+
+  bool FrontTrace::write(const std::string& fname) {
+    int rank = 0, P = 1;
+#if defined(STRUMPACK_USE_MPI)
+    int mpi_initialized = 0, mpi_finalized = 0;
+    MPI_Initialized(&mpi_initialized);
+    MPI_Finalized(&mpi_finalized);
+    if (mpi_initialized && !mpi_finalized) {
+      MPIComm c;
+      rank = c.rank();
+      P = c.size();
+    }
+#endif
+    std::ofstream f(P > 1 ? fname + "." + std::to_string(rank) : fname);
+    if (!f) return false;
+    // Chrome trace time stamps and durations are in microseconds
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+    f << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (auto& e : events()) {
+      if (!first) f << "," << std::endl;
+      first = false;
+      f << "{\"name\":\"" << get_name(e.phase) << " " << e.front
+        << "\",\"cat\":\"" << get_name(e.phase)
+        << "\",\"ph\":\"X\",\"ts\":" << e.start * 1e6
+        << ",\"dur\":" << (e.stop - e.start) * 1e6
+        << ",\"pid\":" << rank << ",\"tid\":" << e.tid
+        << ",\"args\":{\"front\":" << e.front
+        << ",\"level\":" << e.level
+        << ",\"dim_sep\":" << e.dim_sep
+        << ",\"dim_upd\":" << e.dim_upd
+        << ",\"type\":\"" << e.type
+        << "\",\"flops\":" << e.flops
+        << ",\"bytes\":" << e.bytes << "}}";
+    }
+    f << std::endl << "]}" << std::endl;
+    return bool(f);
+  }
+
+} // end namespace strumpack
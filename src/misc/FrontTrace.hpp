@@ -0,0 +1,192 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file FrontTrace.hpp
+ * \brief Opt-in recording of per-front events of the multifrontal
+ * factorization, exported in the Chrome trace event format.
+ */
+#ifndef STRUMPACK_FRONT_TRACE_HPP
+#define STRUMPACK_FRONT_TRACE_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+#include "StrumpackConfig.hpp"
+
+namespace strumpack {
+
+  template<typename scalar_t,typename integer_t> class FrontalMatrix;
+
+  /**
+   * Phases of the processing of a single front.
+   */
+  enum class FrontPhase {
+    ASSEMBLY,   /*!< allocation, extraction from the sparse matrix,
+                     and extend-add from the children */
+    FACTOR,     /*!< (partial) factorization of the front         */
+    EXTEND_ADD  /*!< extend-add of the contribution block to the
+                     parent front                                  */
+  };
+
+  /**
+   * Return a string with the name of the front phase.
+   */
+  std::string get_name(FrontPhase p);
+
+  /**
+   * A single recorded event, one phase of one front.
+   */
+  struct FrontTraceEvent {
+    FrontPhase phase;
+    long long front;      // index of the separator
+    int level;            // level in the elimination tree, root is 0
+    long long dim_sep, dim_upd;
+    std::string type;     // front type, FrontalMatrix::type()
+    int tid;
+    double start, stop;   // seconds since FrontTrace::enable
+    long long flops, bytes;
+  };
+
+  /**
+   * \class FrontTrace
+   * \brief Global recorder for FrontTraceEvents.
+   *
+   * Recording is disabled by default, and then FrontTraceScope only
+   * checks a flag. Events are stored per thread, so threads do not
+   * have to synchronize when recording. The trace can be written as
+   * a JSON file in the Chrome trace event format, which can be
+   * visualized with chrome://tracing or https://ui.perfetto.dev.
+   * This is enabled in the sparse solver with
+   * SPOptions::set_trace_file.
+   */
+  class FrontTrace {
+  public:
+    /**
+     * Clear all events and start recording. Time stamps are relative
+     * to this call.
+     */
+    static void enable();
+
+    /**
+     * Stop recording, the events are kept.
+     */
+    static void disable();
+
+    static bool enabled() { return enabled_; }
+
+    /**
+     * Seconds since the last call to enable.
+     */
+    static double now() {
+      return std::chrono::duration<double>
+        (std::chrono::steady_clock::now() - t_begin_).count();
+    }
+
+    static void record(FrontTraceEvent&& e);
+
+    /**
+     * Return all recorded events, sorted by start time.
+     */
+    static std::vector<FrontTraceEvent> events();
+
+    /**
+     * Write all recorded events to a file in the Chrome trace event
+     * format. When running with more than one MPI rank, every rank
+     * writes its own file, fname.rank, and the rank is used as the
+     * process id in the trace.
+     *
+     * \return false if the file could not be written
+     */
+    static bool write(const std::string& fname);
+
+  private:
+    static bool enabled_;
+    static std::chrono::steady_clock::time_point t_begin_;
+    static std::vector<std::vector<FrontTraceEvent>> thread_events_;
+    static std::vector<FrontTraceEvent> other_events_;
+    static std::mutex other_mtx_;
+  };
+
+  /**
+   * Records one phase of a front, from construction to destruction,
+   * if FrontTrace is enabled.
+   */
+  class FrontTraceScope {
+  public:
+    /**
+     * \param phase phase of the front processing
+     * \param f the front, a FrontalMatrix
+     * \param level level of f in the elimination tree
+     * \param flops number of flops for this phase, can be updated
+     * later with add_flops
+     * \param bytes number of bytes of memory written in this phase
+     */
+    template<typename scalar_t,typename integer_t> FrontTraceScope
+    (FrontPhase phase, const FrontalMatrix<scalar_t,integer_t>* f, int level,
+     long long flops=0, long long bytes=0)
+      : active_(FrontTrace::enabled()) {
+      if (!active_) return;
+      e_.phase = phase;
+      e_.front = f->sep();
+      e_.level = level;
+      e_.dim_sep = f->dim_sep();
+      e_.dim_upd = f->dim_upd();
+      e_.type = f->type();
+#if defined(_OPENMP)
+      e_.tid = omp_get_thread_num();
+#else
+      e_.tid = 0;
+#endif
+      e_.flops = flops;
+      e_.bytes = bytes;
+      e_.start = FrontTrace::now();
+    }
+    ~FrontTraceScope() {
+      if (!active_) return;
+      e_.stop = FrontTrace::now();
+      FrontTrace::record(std::move(e_));
+    }
+
+    void add_flops(long long flops) { if (active_) e_.flops += flops; }
+    void add_bytes(long long bytes) { if (active_) e_.bytes += bytes; }
+
+  private:
+    bool active_;
+    FrontTraceEvent e_;
+
+    FrontTraceScope(const FrontTraceScope&) = delete;
+    FrontTraceScope& operator=(const FrontTraceScope&) = delete;
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_FRONT_TRACE_HPP
@@ -0,0 +1,188 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file MemoryPool.hpp
+ * \brief Contains a simple thread-safe pool of reusable buffers.
+ */
+#ifndef STRUMPACK_MEMORY_POOL_HPP
+#define STRUMPACK_MEMORY_POOL_HPP
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include "StrumpackParameters.hpp"
+
+namespace strumpack {
+
+  /**
+   * \class MemoryPool
+   * \brief Pool of reusable memory blocks.
+   *
+   * Blocks which are returned to the pool are kept in a free list
+   * per thread and handed out again by a subsequent get call on the
+   * same thread, instead of going back to the system allocator. This
+   * avoids repeated calls to malloc/free and the page faults on
+   * freshly allocated memory. This is used for the contribution
+   * blocks of the frontal matrices, which are created and released
+   * in postorder during the multifrontal factorization.
+   *
+   * The memory of all blocks, in use or kept in a free list, is
+   * counted with STRUMPACK_ADD_MEMORY/STRUMPACK_SUB_MEMORY, from
+   * allocation until it is released to the system. The free blocks
+   * are released with clear.
+   *
+   * \tparam T type of the elements, should be trivial
+   */
+  template<typename T> class MemoryPool {
+    /**
+     * Deleter for the blocks, which also updates the memory counter.
+     */
+    struct Free {
+      Free(std::size_t n=0) : n(n) {}
+      std::size_t n;
+      void operator()(T* p) const {
+        STRUMPACK_SUB_MEMORY(n*sizeof(T));
+        delete[] p;
+      }
+    };
+
+  public:
+    /**
+     * A block of memory, with at least size elements, obtained from
+     * the pool. This should be given back to the pool with put.
+     */
+    struct Block {
+      std::unique_ptr<T[],Free> data;
+      std::size_t size = 0;
+      T* get() const { return data.get(); }
+      explicit operator bool() const { return bool(data); }
+      void reset() { data.reset(); size = 0; }
+    };
+
+    /**
+     * Allocate a new block with n elements, not from the pool. This
+     * can be used for memory that is counted like the pool memory,
+     * but is not reused.
+     */
+    static Block allocate(std::size_t n) {
+      Block b;
+      if (!n) return b;
+      b.data = std::unique_ptr<T[],Free>(new T[n], Free(n));
+      b.size = n;
+      STRUMPACK_ADD_MEMORY(n*sizeof(T));
+      return b;
+    }
+
+    /**
+     * Create an empty pool.
+     *
+     * \param max_blocks maximum number of free blocks kept per
+     * thread, when more blocks are returned, the smallest is freed
+     */
+    MemoryPool(std::size_t max_blocks=8)
+      : lists_(std::max(1, params::num_threads)),
+        max_blocks_(max_blocks) {}
+
+    /**
+     * Get a block with at least n elements, from the free list of
+     * the calling thread if possible (the smallest block which is
+     * large enough), newly allocated otherwise. The memory is not
+     * initialized.
+     */
+    Block get(std::size_t n) {
+      Block b;
+      if (!n) return b;
+      auto& l = list();
+      {
+        std::lock_guard<std::mutex> lock(l.m);
+        auto best = l.blocks.end();
+        for (auto it=l.blocks.begin(); it!=l.blocks.end(); it++)
+          if (it->size >= n &&
+              (best == l.blocks.end() || it->size < best->size))
+            best = it;
+        if (best != l.blocks.end()) {
+          b = std::move(*best);
+          l.blocks.erase(best);
+          return b;
+        }
+      }
+      return allocate(n);
+    }
+
+    /**
+     * Return a block to the free list of the calling thread. The
+     * block will be empty on return.
+     */
+    void put(Block& b) {
+      if (!b.data) return;
+      auto& l = list();
+      std::lock_guard<std::mutex> lock(l.m);
+      l.blocks.push_back(std::move(b));
+      b.size = 0;
+      if (l.blocks.size() > max_blocks_) {
+        auto smallest = std::min_element
+          (l.blocks.begin(), l.blocks.end(),
+           [](const Block& a, const Block& c) { return a.size < c.size; });
+        l.blocks.erase(smallest);
+      }
+    }
+
+    /**
+     * Release all free blocks. Blocks that are still in use are not
+     * affected.
+     */
+    void clear() {
+      for (auto& l : lists_) {
+        std::lock_guard<std::mutex> lock(l.m);
+        l.blocks.clear();
+      }
+    }
+
+    ~MemoryPool() { clear(); }
+
+  private:
+    struct FreeList {
+      std::mutex m;
+      std::vector<Block> blocks;
+    };
+    std::vector<FreeList> lists_;
+    std::size_t max_blocks_;
+
+    FreeList& list() {
+#if defined(_OPENMP)
+      return lists_[omp_get_thread_num() % lists_.size()];
+#else
+      return lists_[0];
+#endif
+    }
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_MEMORY_POOL_HPP
@@ -35,7 +35,10 @@
 
 #include <memory>
 #include <random>
+#include <algorithm>
 #include <iostream>
+#include <cstdint>
+#include <cmath>
 
 namespace strumpack {
 
@@ -51,7 +54,9 @@ namespace strumpack {
      */
     enum class RandomEngine {
       LINEAR,   /*!< The C++11 std::minstd_rand random number generator. */
-      MERSENNE  /*!< The C++11 std::mt19937 random number generator.     */
+      MERSENNE, /*!< The C++11 std::mt19937 random number generator.     */
+      PHILOX    /*!< Counter based Philox4x32-10 generator, see
+                  PhiloxGenerator.                                     */
     };
 
     /**
@@ -63,6 +68,7 @@ namespace strumpack {
       switch (e) {
       case RandomEngine::LINEAR: return "minstd_rand"; break;
       case RandomEngine::MERSENNE: return "mt19937"; break;
+      case RandomEngine::PHILOX: return "philox"; break;
       }
       return "unknown";
     }
@@ -111,6 +117,34 @@ namespace strumpack {
       virtual real_t get() = 0;
       virtual real_t get(std::uint32_t i, std::uint32_t j) = 0;
       virtual int flops_per_prng() = 0;
+
+      /**
+       * Fill the m x n column major array A, with leading dimension
+       * ld, with the next m*n random numbers, column by column.
+       */
+      virtual void fill(std::size_t m, std::size_t n,
+                        real_t* A, std::size_t ld) {
+        for (std::size_t c=0; c<n; c++)
+          for (std::size_t r=0; r<m; r++)
+            A[r+c*ld] = get();
+      }
+
+      /**
+       * Fill the m x n column major array A, with leading dimension
+       * ld, such that row r is the first n numbers after
+       * seed(I[r], j). This gives reproducible rows, for instance
+       * for a matrix row with global index I[r] and starting column
+       * j, independent of how the rows are distributed.
+       */
+      virtual void fill(std::size_t m, std::size_t n,
+                        const std::uint32_t* I, std::uint32_t j,
+                        real_t* A, std::size_t ld) {
+        for (std::size_t r=0; r<m; r++) {
+          seed(I[r], j);
+          for (std::size_t c=0; c<n; c++)
+            A[r+c*ld] = get();
+        }
+      }
     };
 
     /**
@@ -190,6 +224,221 @@ namespace strumpack {
       D d;
     };
 
+    /**
+     * \class PhiloxGenerator
+     * \brief Counter based random number generator
+     *
+     * Uses the Philox4x32-10 bijection (Salmon et al., "Parallel
+     * random numbers: as easy as 1, 2, 3", SC11) to map a 128 bit
+     * counter and a 64 bit key to 4 random 32 bit words. Each call
+     * gives 2 double or 4 float uniform numbers, normal numbers are
+     * generated in pairs with the Box-Muller transform. The key is
+     * set by the seed, the counter is the position in a stream,
+     * together with the stream index (i,j) set by seed(i, j).
+     * Hence, the k-th number after seed(i, j) is a pure function of
+     * the seed, i, j and k, and it costs nothing to set a new
+     * stream. Contrary to the std engines, reseeding does not
+     * require setting up a new state, and filling an array does not
+     * require a sequential pass over the stream.
+     *
+     * \tparam real_t float or double
+     * \tparam normal normal(0,1) if true, else uniform [0,1)
+     *
+     * \see RandomGeneratorBase
+     */
+    template<typename real_t, bool normal>
+    class PhiloxGenerator : public RandomGeneratorBase<real_t> {
+      // random numbers per evaluation of the bijection
+      static const int V = sizeof(real_t) == 8 ? 2 : 4;
+
+    public:
+      /**
+       * Default constructor, using seed 0.
+       */
+      PhiloxGenerator() { seed(std::size_t(0)); }
+
+      /**
+       * Constructor using seed s.
+       */
+      PhiloxGenerator(std::size_t s) { seed(s); }
+
+      /**
+       * Seed with value s, start at the beginning of the default
+       * stream.
+       */
+      void seed(std::size_t s) {
+        k0_ = std::uint32_t(s);
+        k1_ = std::uint32_t(std::uint64_t(s) >> 32);
+        set_stream(0, 0, false);
+      }
+
+      /**
+       * Seed with a seed sequence, start at the beginning of the
+       * default stream.
+       */
+      void seed(std::seed_seq& s) {
+        std::uint32_t k[2];
+        s.generate(k, k+2);
+        k0_ = k[0];
+        k1_ = k[1];
+        set_stream(0, 0, false);
+      }
+
+      /**
+       * Start at the beginning of stream (i,j), the key is not
+       * modified.
+       */
+      void seed(std::uint32_t i, std::uint32_t j) { set_stream(i, j, true); }
+
+      /**
+       * Get the next random element.
+       */
+      real_t get() {
+        if (l_ == V) {
+          block(pos_ / V, buf_);
+          l_ = 0;
+        }
+        pos_++;
+        return buf_[l_++];
+      }
+
+      /**
+       * Get the first element of stream (i,j).
+       */
+      real_t get(std::uint32_t i, std::uint32_t j) {
+        real_t v[V];
+        block(0, i, j, true, v);
+        return v[0];
+      }
+
+      /**
+       * Return the (approximate) number of flops required to generate
+       * a random number.
+       */
+      int flops_per_prng() { return normal ? 30 : 12; }
+
+      void fill(std::size_t m, std::size_t n,
+                real_t* A, std::size_t ld) override {
+        for (std::size_t c=0; c<n; c++) {
+          auto a = A + c*ld;
+          std::size_t r = 0;
+          for (; r<m && l_<V; r++) a[r] = get();
+          // full blocks, independent, can be computed in any order
+          const std::uint64_t b0 = pos_ / V;
+          const std::size_t nb = (m - r) / V;
+#pragma omp simd
+          for (std::size_t b=0; b<nb; b++)
+            block(b0 + b, a + r + b*V);
+          r += nb * V;
+          pos_ += nb * V;
+          for (; r<m; r++) a[r] = get();
+        }
+      }
+
+      void fill(std::size_t m, std::size_t n,
+                const std::uint32_t* I, std::uint32_t j,
+                real_t* A, std::size_t ld) override {
+        const std::size_t nb = (n + V - 1) / V;
+        for (std::size_t r=0; r<m; r++) {
+          for (std::size_t b=0; b<nb; b++) {
+            real_t v[V];
+            block(b, I[r], j, true, v);
+            for (std::size_t c=b*V; c<std::min(n, (b+1)*V); c++)
+              A[r+c*ld] = v[c-b*V];
+          }
+        }
+        if (m) {
+          set_stream(I[m-1], j, true);
+          skip_to(n);
+        }
+      }
+
+    private:
+      std::uint32_t k0_ = 0, k1_ = 0;  // key
+      std::uint32_t i_ = 0, j_ = 0;    // stream
+      bool ij_ = false;                // stream set with seed(i,j)
+      std::uint64_t pos_ = 0;          // position in the stream
+      real_t buf_[V];
+      int l_ = V;                      // next unused element of buf_
+
+      void set_stream(std::uint32_t i, std::uint32_t j, bool ij) {
+        i_ = i; j_ = j; ij_ = ij;
+        pos_ = 0;
+        l_ = V;
+      }
+
+      void skip_to(std::uint64_t pos) {
+        pos_ = pos;
+        l_ = pos % V;
+        if (l_) block(pos / V, buf_);
+        else l_ = V;
+      }
+
+      void block(std::uint64_t b, real_t* v) const {
+        block(b, i_, j_, ij_, v);
+      }
+
+      /**
+       * Compute the V random numbers of block b of stream (i,j). The
+       * counter is (b, i, j), the streams set with seed(i,j) are
+       * separated from the default stream by the second word of the
+       * counter.
+       */
+      void block(std::uint64_t b, std::uint32_t i, std::uint32_t j,
+                 bool ij, real_t* v) const {
+        std::uint32_t c0 = std::uint32_t(b),
+          c1 = ij ? 0xFFFFFFFFu : std::uint32_t(b >> 32),
+          c2 = i, c3 = j, k0 = k0_, k1 = k1_;
+        for (int round=0; round<10; round++) {
+          const std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c0,
+            p1 = std::uint64_t(0xCD9E8D57u) * c2;
+          const std::uint32_t hi0 = std::uint32_t(p0 >> 32),
+            lo0 = std::uint32_t(p0), hi1 = std::uint32_t(p1 >> 32),
+            lo1 = std::uint32_t(p1);
+          c0 = hi1 ^ c1 ^ k0;
+          c1 = lo1;
+          c2 = hi0 ^ c3 ^ k1;
+          c3 = lo0;
+          k0 += 0x9E3779B9u;
+          k1 += 0xBB67AE85u;
+        }
+        to_real(c0, c1, c2, c3, v);
+      }
+
+      // uniform [0,1) from 53 (double) or 24 (float) random bits
+      static double u53(std::uint32_t a, std::uint32_t b) {
+        return ((std::uint64_t(a) << 21) ^ (b >> 11)) *
+          (1. / 9007199254740992.);
+      }
+      static float u24(std::uint32_t a) {
+        return (a >> 8) * (1.f / 16777216.f);
+      }
+      static void box_muller(real_t u1, real_t u2, real_t* v) {
+        // 1-u1 is in (0,1], avoids log(0)
+        const real_t rad = std::sqrt(real_t(-2.) * std::log(real_t(1.) - u1)),
+          t = real_t(6.283185307179586476925) * u2;
+        v[0] = rad * std::cos(t);
+        v[1] = rad * std::sin(t);
+      }
+      static void to_real(std::uint32_t c0, std::uint32_t c1,
+                          std::uint32_t c2, std::uint32_t c3, double* v) {
+        v[0] = u53(c0, c1);
+        v[1] = u53(c2, c3);
+        if (normal) box_muller(v[0], v[1], v);
+      }
+      static void to_real(std::uint32_t c0, std::uint32_t c1,
+                          std::uint32_t c2, std::uint32_t c3, float* v) {
+        v[0] = u24(c0);
+        v[1] = u24(c1);
+        v[2] = u24(c2);
+        v[3] = u24(c3);
+        if (normal) {
+          box_muller(v[0], v[1], v);
+          box_muller(v[2], v[3], v+2);
+        }
+      }
+    };
+
     /**
      * Factory method to construct a RandomGeneratorBase with a
      * specified random engine and random distribution, with seed s.
@@ -212,6 +461,13 @@ namespace strumpack {
           return std::unique_ptr<RandomGeneratorBase<real_t>>
             (new RandomGenerator<real_t,std::minstd_rand,
              std::uniform_real_distribution<real_t>>(seed));
+      } else if (e == RandomEngine::PHILOX) {
+        if (d == RandomDistribution::NORMAL)
+          return std::unique_ptr<RandomGeneratorBase<real_t>>
+            (new PhiloxGenerator<real_t,true>(seed));
+        else if (d == RandomDistribution::UNIFORM)
+          return std::unique_ptr<RandomGeneratorBase<real_t>>
+            (new PhiloxGenerator<real_t,false>(seed));
       } else if (e == RandomEngine::MERSENNE) {
         if (d == RandomDistribution::NORMAL)
           return std::unique_ptr<RandomGeneratorBase<real_t>>
@@ -32,6 +32,7 @@
 #include <tuple>
 #include <algorithm>
 #include <string>
+#include <complex>
 
 #include "CSRMatrix.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -213,48 +214,166 @@ namespace strumpack {
 //   }
 // #endif
 
+  /**
+   * Split the rows [0,n) in nb consecutive blocks, each with about the
+   * same number of nonzeros plus rows. Splitting by nonzeros instead
+   * of by rows keeps a few long rows from ending up in a single
+   * block, and counting the rows too keeps empty rows from being free.
+   */
+  template<typename integer_t> static std::vector<integer_t>
+  spmv_row_blocks(integer_t n, const integer_t* ptr, int nb) {
+    std::vector<integer_t> b(nb+1, n);
+    const long long W = (long long)(ptr[n] - ptr[0]) + n;
+    b[0] = 0;
+    for (int t=1; t<nb; t++) {
+      const long long w = W * t / nb;
+      integer_t lo = b[t-1], hi = n;
+      while (lo < hi) {
+        auto r = lo + (hi - lo) / 2;
+        if ((long long)(ptr[r] - ptr[0]) + r < w) lo = r + 1;
+        else hi = r;
+      }
+      b[t] = lo;
+    }
+    return b;
+  }
+
+  /**
+   * Number of row blocks for the spmv, a few per thread so that the
+   * dynamic schedule can still even out rows that are more expensive
+   * than their number of nonzeros suggests. Small matrices are not
+   * worth starting the threads for.
+   */
+  template<typename integer_t> static int
+  spmv_num_blocks(integer_t n, integer_t nnz) {
+    auto nb = std::min(n, integer_t(4 * params::num_threads));
+    return std::max(1, int(std::min(nb, nnz / 2048)));
+  }
+
+  /**
+   * Dot product of a sparse row with x. For real types the sum is
+   * vectorized. The gather from x still dominates, but the reduction
+   * no longer serializes the loop.
+   */
+  template<typename scalar_t,typename integer_t> static inline scalar_t
+  spmv_row(integer_t lo, integer_t hi, const integer_t* ind,
+           const scalar_t* val, const scalar_t* x) {
+    scalar_t s(0);
+#pragma omp simd reduction(+:s)
+    for (integer_t j=lo; j<hi; j++)
+      s += val[j] * x[ind[j]];
+    return s;
+  }
+  template<typename real_t,typename integer_t>
+  static inline std::complex<real_t>
+  spmv_row(integer_t lo, integer_t hi, const integer_t* ind,
+           const std::complex<real_t>* val, const std::complex<real_t>* x) {
+    std::complex<real_t> s(0);
+    for (integer_t j=lo; j<hi; j++)
+      s += val[j] * x[ind[j]];
+    return s;
+  }
+
+  /**
+   * Y(lo:hi,c:c+NB) = A(lo:hi,:) Xp, with Xp an NB wide row major
+   * panel of X.
+   */
+  template<int NB, typename scalar_t, typename integer_t> static void
+  spmm_panel(integer_t lo, integer_t hi, const integer_t* ptr,
+             const integer_t* ind, const scalar_t* val,
+             const scalar_t* Xp, DenseMatrix<scalar_t>& Y, std::size_t c) {
+    for (integer_t r=lo; r<hi; r++) {
+      scalar_t s[NB] = {};
+      const auto hij = ptr[r+1];
+      for (auto j=ptr[r]; j<hij; j++) {
+        const auto v = val[j];
+        const auto x = Xp + std::size_t(ind[j])*NB;
+#pragma omp simd
+        for (int k=0; k<NB; k++)
+          s[k] += v * x[k];
+      }
+      for (int k=0; k<NB; k++)
+        Y(r, c+k) = s[k];
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::spmv
   (const scalar_t* x, scalar_t* y) const {
-#pragma omp parallel for
-    for (integer_t r=0; r<n_; r++) {
-      const auto hij = ptr_[r+1];
-      scalar_t yr(0);
-      for (integer_t j=ptr_[r]; j<hij; j++)
-        yr += val_[j] * x[ind_[j]];
-      y[r] = yr;
-    }
+    const int nb = spmv_num_blocks(n_, nnz_);
+    const auto b = spmv_row_blocks(n_, ptr_.data(), nb);
+    const auto ptr = ptr_.data();
+    const auto ind = ind_.data();
+    const auto val = val_.data();
+#pragma omp parallel for schedule(dynamic,1) if(nb > 1)
+    for (int t=0; t<nb; t++)
+      for (integer_t r=b[t]; r<b[t+1]; r++)
+        y[r] = spmv_row(ptr[r], ptr[r+1], ind, val, x);
     STRUMPACK_FLOPS(this->spmv_flops());
     STRUMPACK_BYTES(this->spmv_bytes());
   }
 
+  /**
+   * Multiply with all columns of x in panels of (at most) 32
+   * columns. Each panel of x is first copied to row major order, so
+   * that every nonzero of the matrix is loaded once per panel instead
+   * of once per column, and multiplies a contiguous row of the panel.
+   */
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::spmv
   (const DenseM_t& x, DenseM_t& y) const {
     // assert(x.cols() == y.cols());
     // assert(x.rows() == std::size_t(n_));
     // assert(y.rows() == std::size_t(n_));
-    for (std::size_t c=0; c<x.cols(); c++)
-      spmv(x.ptr(0,c), y.ptr(0,c));
+    const std::size_t d = x.cols();
+    if (d == 1) spmv(x.data(), y.data());
+    if (d <= 1) return;
+    const int nb = spmv_num_blocks(n_, nnz_);
+    const auto b = spmv_row_blocks(n_, ptr_.data(), nb);
+    const auto ptr = ptr_.data();
+    const auto ind = ind_.data();
+    const auto val = val_.data();
+    const std::size_t pmax = 32;
+    std::vector<scalar_t> Xp(std::size_t(n_) * std::min(d, pmax));
+    for (std::size_t c=0; c<d; ) {
+      std::size_t p = std::min(d - c, pmax);
+      if (p < pmax) p = (p >= 16) ? 16 : (p >= 8) ? 8 :
+                      (p >= 4) ? 4 : (p >= 2) ? 2 : 1;
+      const auto xp = Xp.data();
+#pragma omp parallel for if(nb > 1)
+      for (integer_t i=0; i<n_; i++)
+        for (std::size_t k=0; k<p; k++)
+          xp[i*p+k] = x(i, c+k);
+#pragma omp parallel for schedule(dynamic,1) if(nb > 1)
+      for (int t=0; t<nb; t++) {
+        switch (p) {
+        case 32: spmm_panel<32>(b[t], b[t+1], ptr, ind, val, xp, y, c); break;
+        case 16: spmm_panel<16>(b[t], b[t+1], ptr, ind, val, xp, y, c); break;
+        case 8:  spmm_panel<8>(b[t], b[t+1], ptr, ind, val, xp, y, c); break;
+        case 4:  spmm_panel<4>(b[t], b[t+1], ptr, ind, val, xp, y, c); break;
+        case 2:  spmm_panel<2>(b[t], b[t+1], ptr, ind, val, xp, y, c); break;
+        default: spmm_panel<1>(b[t], b[t+1], ptr, ind, val, xp, y, c);
+        }
+      }
+      c += p;
+    }
+    STRUMPACK_FLOPS(d*this->spmv_flops());
+    STRUMPACK_BYTES(d*this->spmv_bytes());
   }
 
   // TODO use MKL routines for better performance
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::spmv
   (Trans op, const DenseM_t& x, DenseM_t& y) const {
-    if (op != Trans::N) y.zero();
+    if (op == Trans::N) {
+      spmv(x, y);
+      return;
+    }
+    y.zero();
     for (std::size_t c=0; c<x.cols(); c++) {
       auto px = x.ptr(0, c);
       auto py = y.ptr(0, c);
-      if (op == Trans::N) {
-        for (integer_t r=0; r<n_; r++) {
-          const auto hij = ptr_[r+1];
-          scalar_t yr(0);
-          for (integer_t j=ptr_[r]; j<hij; j++)
-            yr += val_[j] * px[ind_[j]];
-          py[r] = yr;
-        }
-      } else if (op == Trans::T) {
+      if (op == Trans::T) {
         for (integer_t r=0; r<n_; r++) {
           const auto hij = ptr_[r+1];
           for (integer_t j=ptr_[r]; j<hij; j++)
@@ -401,7 +520,6 @@ namespace strumpack {
     return info[0];
   }
 
-  // TODO tasked!!
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::extract_separator
   (integer_t sep_end, const std::vector<std::size_t>& I,
@@ -409,21 +527,20 @@ namespace strumpack {
     const integer_t m = I.size();
     const integer_t n = J.size();
     if (m == 0 || n == 0) return;
+    B.zero();
+    // sort J once, then merge it with the (sorted) column indices of
+    // each row
+    const auto pJ = this->sorted_order(J);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(64)      \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
     for (integer_t i=0; i<m; i++) {
-      integer_t r = I[i];
-      // indices sorted in increasing order
-      auto cmin = ind_[ptr_[r]];
-      auto cmax = ind_[ptr_[r+1]-1];
-      for (integer_t k=0; k<n; k++) {
-        integer_t c = J[k];
-        if (c >= cmin && c <= cmax && (r < sep_end || c < sep_end)) {
-          auto a_pos = ptr_[r];
-          auto a_max = ptr_[r+1];
-          while (a_pos < a_max-1 && ind_[a_pos] < c) a_pos++;
-          B(i,k) = (ind_[a_pos] == c) ?
-            val_[a_pos] : scalar_t(0.);
-        } else B(i,k) = scalar_t(0.);
-      }
+      const integer_t r = I[i];
+      this->merge_extract
+        (ptr_[r], ptr_[r+1], J, pJ,
+         (r < sep_end) ? std::size_t(-1) : std::size_t(sep_end),
+         B.ptr(i, 0), B.ld());
     }
   }
 
@@ -472,6 +589,8 @@ namespace strumpack {
   (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21, integer_t slo,
    integer_t shi, const std::vector<integer_t>& upd, int depth) const {
     integer_t ds = shi - slo, du = upd.size();
+    // F12 can be left empty (symmetric factorization)
+    integer_t du12 = F12.cols();
     for (integer_t row=0; row<ds; row++) { // separator rows
       integer_t upd_ptr = 0;
       const auto hij = ptr_[row+slo+1];
@@ -481,9 +600,9 @@ namespace strumpack {
           if (col < shi)
             F11(row, col-slo) = val_[j];
           else {
-            while (upd_ptr<du && upd[upd_ptr]<col)
+            while (upd_ptr<du12 && upd[upd_ptr]<col)
               upd_ptr++;
-            if (upd_ptr == du) break;
+            if (upd_ptr == du12) break;
             if (upd[upd_ptr] == col)
               F12(row, upd_ptr) = val_[j];
           }
@@ -504,261 +623,138 @@ namespace strumpack {
     }
   }
 
-  template<typename scalar_t,typename integer_t> void
-  CSRMatrix<scalar_t,integer_t>::front_multiply
+  template<typename scalar_t,typename integer_t> bool
+  CSRMatrix<scalar_t,integer_t>::extract_front_map
+  (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21, integer_t slo,
+   integer_t shi, const std::vector<integer_t>& upd,
+   FrontMap_t& map, int depth) const {
+    integer_t ds = shi - slo, du = upd.size();
+    integer_t du12 = F12.cols();
+    for (auto& m : map) m.clear();
+    auto add = [this,&map](int b, DenseM_t& F, integer_t i, integer_t j,
+                      std::size_t k) {
+      std::size_t o = i + j * F.ld();
+      F.data()[o] = val_[k];
+      map[b].emplace_back(k, o);
+    };
+    for (integer_t row=0; row<ds; row++) { // separator rows
+      integer_t upd_ptr = 0;
+      const auto hij = ptr_[row+slo+1];
+      for (integer_t j=ptr_[row+slo]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            add(0, F11, row, col-slo, j);
+          else {
+            while (upd_ptr<du12 && upd[upd_ptr]<col)
+              upd_ptr++;
+            if (upd_ptr == du12) break;
+            if (upd[upd_ptr] == col)
+              add(1, F12, row, upd_ptr, j);
+          }
+        }
+      }
+    }
+    for (integer_t i=0; i<du; i++) { // update rows
+      auto row = upd[i];
+      const auto hij = ptr_[row+1];
+      for (integer_t j=ptr_[row]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            add(2, F21, i, col-slo, j);
+          else break;
+        }
+      }
+    }
+    for (auto& m : map) m.shrink_to_fit();
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  SparseFront<scalar_t,integer_t>
+  CSRMatrix<scalar_t,integer_t>::front_sparse
   (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
-   const DenseM_t& R, DenseM_t& Sr, DenseM_t& Sc, int depth) const {
-    integer_t dupd = upd.size();
-    const integer_t nbvec = R.cols();
-    const integer_t ds = shi - slo;
-    const auto B = 4; // blocking parameter
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-    for (integer_t c=0; c<nbvec; c+=B) {
-      long long int local_flops = 0;
+   int blocks) const {
+    using SF_t = SparseFront<scalar_t,integer_t>;
+    const integer_t ds = shi - slo, dupd = upd.size();
+    const bool sep_rows = blocks & (SF_t::F11 | SF_t::F12);
+    const bool sep_cols = blocks & (SF_t::F11 | SF_t::F21);
+    // offsets of the update rows/columns in the local numbering
+    const integer_t ur = sep_rows ? ds : 0, uc = sep_cols ? ds : 0;
+    std::vector<Triplet<scalar_t,integer_t>> e;
+    if (sep_rows) {
       for (auto row=slo; row<shi; row++) { // separator rows
         integer_t upd_ptr = 0;
         const auto hij = ptr_[row+1];
         for (auto j=ptr_[row]; j<hij; j++) {
           const auto col = ind_[j];
-          if (col >= slo) {
-            const auto hicc = std::min(c+B, nbvec);
-            const auto vj = val_[j];
-            if (col < shi) {
-              for (integer_t cc=c; cc<hicc; cc++) {
-                Sr(row-slo, cc) += vj * R(col-slo, cc);
-                Sc(col-slo, cc) += blas::my_conj(vj) * R(row-slo, cc);
-              }
-              local_flops += 4*(hicc-c);
-            } else {
-              while (upd_ptr<dupd && upd[upd_ptr]<col) upd_ptr++;
-              if (upd_ptr == dupd) break;
-              if (upd[upd_ptr] == col) {
-                for (integer_t cc=c; cc<hicc; cc++) {
-                  Sr(row-slo, cc) += vj * R(ds+upd_ptr, cc);
-                  Sc(ds+upd_ptr, cc) += blas::my_conj(vj) * R(row-slo, cc);
-                }
-                local_flops += 4*(hicc-c);
-              }
-            }
+          if (col < slo) continue;
+          if (col < shi) {
+            if (blocks & SF_t::F11)
+              e.emplace_back(row-slo, col-slo, val_[j]);
+          } else {
+            if (!(blocks & SF_t::F12)) break;
+            while (upd_ptr<dupd && upd[upd_ptr]<col) upd_ptr++;
+            if (upd_ptr == dupd) break;
+            if (upd[upd_ptr] == col)
+              e.emplace_back(row-slo, uc+upd_ptr, val_[j]);
           }
         }
       }
-      STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
-      STRUMPACK_SPARSE_SAMPLE_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
     }
-
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-    for (integer_t c=0; c<nbvec; c+=B) {
-      long long int local_flops = 0;
-      for (integer_t i=0; i<dupd; i++) { // remaining rows
-        auto row = upd[i];
+    if (blocks & SF_t::F21) {
+      for (integer_t i=0; i<dupd; i++) { // update rows
+        const auto row = upd[i];
         const auto hij = ptr_[row+1];
         for (auto j=ptr_[row]; j<hij; j++) {
-          auto col = ind_[j];
-          if (col >= slo) {
-            if (col < shi) {
-              const auto vj = val_[j];
-              const auto hicc = std::min(c+B, nbvec);
-              for (integer_t cc=c; cc<hicc; cc++) {
-                Sr(ds+i, cc) += vj * R(col-slo, cc);
-                Sc(col-slo, cc) += vj * R(ds+i, cc);
-              }
-              local_flops += 4*(hicc-c);
-            } else break;
-          }
+          const auto col = ind_[j];
+          if (col < slo) continue;
+          if (col < shi) e.emplace_back(ur+i, col-slo, val_[j]);
+          else break;
         }
       }
-      STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
-      STRUMPACK_SPARSE_SAMPLE_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
     }
+    const integer_t m = ur + ((blocks & SF_t::F21) ? dupd : 0);
+    const integer_t n = uc + ((blocks & SF_t::F12) ? dupd : 0);
+    return SF_t(m, n, e);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::front_multiply
+  (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+   const DenseM_t& R, DenseM_t& Sr, DenseM_t& Sc, int depth) const {
+    using SF_t = SparseFront<scalar_t,integer_t>;
+    auto F = front_sparse(slo, shi, upd, SF_t::ALL);
+    F.multiply(Trans::N, R, Sr, depth);
+    F.multiply(Trans::C, R, Sc, depth);
   }
 
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::front_multiply_F11
   (Trans op, integer_t slo, integer_t shi,
    const DenseM_t& R, DenseM_t& S, int depth) const {
-    const integer_t nbvec = R.cols();
-    const auto B = 4; // blocking parameter
-    long long int local_flops = 0;
-    if (op == Trans::N) {
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-      for (integer_t c=0; c<nbvec; c+=B)
-        for (auto row=slo; row<shi; row++) { // separator rows
-          const auto hij = ptr_[row+1];
-          for (auto j=ptr_[row]; j<hij; j++) {
-            const auto col = ind_[j];
-            if (col >= slo) {
-              const auto hicc = std::min(c+B, nbvec);
-              const auto vj = val_[j];
-              if (col < shi) {
-                for (integer_t cc=c; cc<hicc; cc++)
-                  S(row-slo, cc) += vj * R(col-slo, cc);
-                local_flops += 4*(hicc-c);
-              }
-            }
-          }
-        }
-    } else {
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-      for (integer_t c=0; c<nbvec; c+=B) {
-        long long int local_flops = 0;
-        for (auto row=slo; row<shi; row++) { // separator rows
-          const auto hij = ptr_[row+1];
-          for (auto j=ptr_[row]; j<hij; j++) {
-            const auto col = ind_[j];
-            if (col >= slo) {
-              const auto hicc = std::min(c+B, nbvec);
-              const auto vj = val_[j];
-              if (col < shi) {
-                for (integer_t cc=c; cc<hicc; cc++)
-                  S(col-slo, cc) += blas::my_conj(vj) * R(row-slo, cc);
-                local_flops += 4*(hicc-c);
-              }
-            }
-          }
-        }
-      }
-    }
-    STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
-    STRUMPACK_SPARSE_SAMPLE_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
+    using SF_t = SparseFront<scalar_t,integer_t>;
+    front_sparse(slo, shi, std::vector<integer_t>(), SF_t::F11).multiply
+      (op == Trans::N ? op : Trans::C, R, S, depth);
   }
 
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::front_multiply_F12
   (Trans op, integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
    const DenseM_t& R, DenseM_t& S, int depth) const {
-    integer_t dupd = upd.size();
-    const integer_t nbvec = R.cols();
-    long long int local_flops = 0;
-    const auto B = 4; // blocking parameter
-    if (op == Trans::N) {
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-      for (integer_t c=0; c<nbvec; c+=B) {
-        for (auto row=slo; row<shi; row++) { // separator rows
-          integer_t upd_ptr = 0;
-          const auto hij = ptr_[row+1];
-          for (auto j=ptr_[row]; j<hij; j++) {
-            const auto col = ind_[j];
-            if (col >= slo) {
-              const auto hicc = std::min(c+B, nbvec);
-              const auto vj = val_[j];
-              if (col >= shi) {
-                while (upd_ptr<dupd && upd[upd_ptr]<col) upd_ptr++;
-                if (upd_ptr == dupd) break;
-                if (upd[upd_ptr] == col) {
-                  for (integer_t cc=c; cc<hicc; cc++)
-                    S(row-slo, cc) += vj * R(upd_ptr, cc);
-                  local_flops += 4*(hicc-c);
-                }
-              }
-            }
-          }
-        }
-      }
-    } else {
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-      for (integer_t c=0; c<nbvec; c+=B) {
-        for (auto row=slo; row<shi; row++) { // separator rows
-          integer_t upd_ptr = 0;
-          const auto hij = ptr_[row+1];
-          for (auto j=ptr_[row]; j<hij; j++) {
-            const auto col = ind_[j];
-            if (col >= slo) {
-              const auto hicc = std::min(c+B, nbvec);
-              const auto vj = val_[j];
-              if (col >= shi) {
-                while (upd_ptr<dupd && upd[upd_ptr]<col) upd_ptr++;
-                if (upd_ptr == dupd) break;
-                if (upd[upd_ptr] == col) {
-                  for (integer_t cc=c; cc<hicc; cc++)
-                    S(upd_ptr, cc) += blas::my_conj(vj) * R(row-slo, cc);
-                  local_flops += 4*(hicc-c);
-                }
-              }
-            }
-          }
-        }
-      }
-    }
-    STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
-    STRUMPACK_SPARSE_SAMPLE_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
+    using SF_t = SparseFront<scalar_t,integer_t>;
+    front_sparse(slo, shi, upd, SF_t::F12).multiply
+      (op == Trans::N ? op : Trans::C, R, S, depth);
   }
 
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::front_multiply_F21
   (Trans op, integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
    const DenseM_t& R, DenseM_t& S, int depth) const {
-    integer_t dupd = upd.size();
-    const integer_t nbvec = R.cols();
-    long long int local_flops = 0;
-    const auto B = 4; // blocking parameter
-    if (op == Trans::N) {
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-      for (integer_t c=0; c<nbvec; c+=B) {
-        for (integer_t i=0; i<dupd; i++) { // remaining rows
-          auto row = upd[i];
-          const auto hij = ptr_[row+1];
-          for (auto j=ptr_[row]; j<hij; j++) {
-            auto col = ind_[j];
-            if (col >= slo) {
-              if (col < shi) {
-                const auto vj = val_[j];
-                const auto hicc = std::min(c+B, nbvec);
-                for (integer_t cc=c; cc<hicc; cc++)
-                  S(i, cc) += vj * R(col-slo, cc);
-                local_flops += 4*(hicc-c);
-              } else break;
-            }
-          }
-        }
-      }
-    } else {
-#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared)                    \
-  if(depth < params::task_recursion_cutoff_level)
-#endif
-      for (integer_t c=0; c<nbvec; c+=B) {
-        for (integer_t i=0; i<dupd; i++) { // remaining rows
-          auto row = upd[i];
-          const auto hij = ptr_[row+1];
-          for (auto j=ptr_[row]; j<hij; j++) {
-            auto col = ind_[j];
-            if (col >= slo) {
-              if (col < shi) {
-                const auto vj = val_[j];
-                const auto hicc = std::min(c+B, nbvec);
-                for (integer_t cc=c; cc<hicc; cc++)
-                  S(col-slo, cc) += vj * R(i, cc);
-                local_flops += 4*(hicc-c);
-              } else break;
-            }
-          }
-        }
-      }
-    }
-    STRUMPACK_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
-    STRUMPACK_SPARSE_SAMPLE_FLOPS((is_complex<scalar_t>() ? 4 : 1) * local_flops);
+    using SF_t = SparseFront<scalar_t,integer_t>;
+    front_sparse(slo, shi, upd, SF_t::F21).multiply
+      (op == Trans::N ? op : Trans::C, R, S, depth);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -37,6 +37,7 @@
 
 #include "CompressedSparseMatrix.hpp"
 #include "CSRGraph.hpp"
+#include "SparseFront.hpp"
 
 namespace strumpack {
 
@@ -61,6 +62,7 @@ namespace strumpack {
     using real_t = typename RealType<scalar_t>::value_type;
     using Match_t = MatchingData<scalar_t,integer_t>;
     using Equil_t = Equilibration<scalar_t>;
+    using FrontMap_t = typename CSM_t::FrontMap_t;
 
   public:
     CSRMatrix();
@@ -116,6 +118,10 @@ namespace strumpack {
     (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21, integer_t sep_begin,
      integer_t sep_end, const std::vector<integer_t>& upd,
      int depth) const override;
+    bool extract_front_map
+    (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21, integer_t sep_begin,
+     integer_t sep_end, const std::vector<integer_t>& upd,
+     FrontMap_t& map, int depth) const override;
 
     void push_front_elements
     (integer_t, integer_t, const std::vector<integer_t>&,
@@ -174,6 +180,14 @@ namespace strumpack {
     using CSM_t::ind_;
     using CSM_t::val_;
     using CSM_t::symm_sparse_;
+
+    /**
+     * Gather the requested blocks (see SparseFront::Blocks) of the
+     * front with separator [slo,shi) and update indices upd.
+     */
+    SparseFront<scalar_t,integer_t> front_sparse
+    (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+     int blocks) const;
   };
 
 } // end namespace strumpack
@@ -28,6 +28,7 @@
  */
 #include <vector>
 #include <algorithm>
+#include <numeric>
 #include <tuple>
 #include <cstdio>
 #include <cstring>
@@ -338,6 +339,51 @@ namespace strumpack {
     std::swap(val_, val);
   }
 
+  template<typename scalar_t,typename integer_t> std::vector<std::size_t>
+  CompressedSparseMatrix<scalar_t,integer_t>::sorted_order
+  (const std::vector<std::size_t>& idx) {
+    std::vector<std::size_t> perm(idx.size());
+    std::iota(perm.begin(), perm.end(), 0);
+    if (!std::is_sorted(idx.begin(), idx.end()))
+      std::sort(perm.begin(), perm.end(),
+                [&idx](std::size_t a, std::size_t b) {
+                  return idx[a] < idx[b]; });
+    return perm;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::merge_extract
+  (integer_t lo, integer_t hi, const std::vector<std::size_t>& idx,
+   const std::vector<std::size_t>& perm, std::size_t lim,
+   scalar_t* b, std::size_t incb) const {
+    const std::size_t n = perm.size();
+    if (std::size_t(hi - lo) > 8 * n) {
+      // long row/column, few indices: binary search for each index
+      auto first = ind_.begin() + lo;
+      const auto last = ind_.begin() + hi;
+      for (std::size_t k=0; k<n; k++) {
+        const auto j = idx[perm[k]];
+        if (j >= lim) break;
+        first = std::lower_bound(first, last, integer_t(j));
+        if (first == last) break;
+        if (std::size_t(*first) == j)
+          b[perm[k]*incb] = val_[first - ind_.begin()];
+      }
+    } else {
+      std::size_t k = 0;
+      while (lo < hi && k < n) {
+        const std::size_t i = ind_[lo], j = idx[perm[k]];
+        if (i >= lim || j >= lim) break;
+        if (i < j) lo++;
+        else {
+          // do not advance lo, idx can contain duplicates
+          if (i == j) b[perm[k]*incb] = val_[lo];
+          k++;
+        }
+      }
+    }
+  }
+
   template<typename scalar_t,typename integer_t> long long
   CompressedSparseMatrix<scalar_t,integer_t>::spmv_flops() const {
     return (is_complex<scalar_t>() ? 4 : 1 ) * (2ll * nnz_ - n_);
@@ -35,6 +35,7 @@
 #define COMPRESSED_SPARSE_MATRIX_HPP
 
 #include <vector>
+#include <array>
 #include <string>
 #include <tuple>
 
@@ -397,6 +398,29 @@ namespace strumpack {
     (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
      integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
      int depth) const = 0;
+
+    /**
+     * Position of the nonzeros of a front, one list for each of F11,
+     * F12 and F21, with pairs of (index in val(), column-major offset
+     * in the F11/F12/F21 block).
+     */
+    using FrontMap_t = std::array
+      <std::vector<std::pair<std::size_t,std::size_t>>,3>;
+    /**
+     * Same as extract_front, but also record in map where each
+     * nonzero is copied, so a next factorization, with the same
+     * sparsity pattern, can assemble the front by a direct scatter
+     * from val(). Returns false if this is not supported, then the
+     * front is still extracted, but map is not set.
+     */
+    virtual bool extract_front_map
+    (DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+     integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+     FrontMap_t& map, int depth) const {
+      extract_front(F11, F12, F21, slo, shi, upd, depth);
+      return false;
+    }
+
     virtual void push_front_elements
     (integer_t, integer_t, const std::vector<integer_t>&,
      std::vector<Triplet<scalar_t>>&, std::vector<Triplet<scalar_t>>&,
@@ -469,6 +493,23 @@ namespace strumpack {
 
     long long spmv_flops() const;
     long long spmv_bytes() const;
+
+    /**
+     * Permutation that sorts idx in increasing order.
+     */
+    static std::vector<std::size_t>
+    sorted_order(const std::vector<std::size_t>& idx);
+    /**
+     * Merge the (sorted) indices ind_[lo:hi) with the indices
+     * idx[perm[k]], which are sorted by perm, only looking at indices
+     * smaller than lim. For each match, b[perm[k]*incb] is set to the
+     * corresponding value. Used to extract a row or column of a
+     * submatrix.
+     */
+    void merge_extract
+    (integer_t lo, integer_t hi, const std::vector<std::size_t>& idx,
+     const std::vector<std::size_t>& perm, std::size_t lim,
+     scalar_t* b, std::size_t incb) const;
   };
 
 } //end namespace strumpack
@@ -32,6 +32,7 @@
 #include "EliminationTree.hpp"
 #include "fronts/FrontFactory.hpp"
 #include "fronts/FrontalMatrix.hpp"
+#include "fronts/FrontalMatrixDense.hpp"
 
 namespace strumpack {
 
@@ -155,7 +156,44 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const SPOptions<scalar_t>& opts) {
+    setup_factor_store(opts);
+    // spawn tasks based on the estimated cost of the subtrees, not
+    // only on their depth
+    if (params::num_threads > 1) root_->map_threads(params::num_threads);
     root_->multifrontal_factorization(A, opts);
+    // free the contribution blocks cached during the factorization
+    FrontalMatrixDense<scalar_t,integer_t>::CB_pool().clear();
+    // factors are written in the background, finish before checking
+    // factor_store_failed
+    if (factor_store_) factor_store_->wait();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::setup_factor_store
+  (const SPOptions<scalar_t>& opts) {
+    if (!root_) return;
+    // a new factorization overwrites all factors, start from a new file
+    factor_store_.reset(nullptr);
+    if (opts.out_of_core()) {
+      try {
+        factor_store_.reset
+          (new FactorStore<scalar_t>(opts.out_of_core_dir()));
+      } catch (std::exception& e) {
+        std::cerr << "# WARNING: " << e.what()
+                  << ", keeping the factors in memory" << std::endl;
+      }
+    }
+    root_->set_factor_store(factor_store_.get());
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::factor_store_failed() const {
+    return factor_store_ && factor_store_->failed();
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::factor_failed() const {
+    return root_ && root_->factor_failed();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -65,6 +65,18 @@ namespace strumpack {
     virtual void remove_from_gpu();
 
     virtual void multifrontal_solve(DenseM_t& x) const;
+
+    /**
+     * Whether writing or reading the out-of-core factors failed, in
+     * the last factorization or any solve after that.
+     */
+    virtual bool factor_store_failed() const;
+
+    /**
+     * Whether the last factorization failed because of a zero pivot
+     * (for Cholesky, a matrix which is not positive definite).
+     */
+    virtual bool factor_failed() const;
     virtual void multifrontal_solve_dist
     (DenseM_t& x, const std::vector<integer_t>& dist) {} // TODO const
 
@@ -80,6 +92,9 @@ namespace strumpack {
     FrontCounter nr_fronts_;
     std::unique_ptr<F_t> root_;
     std::unique_ptr<GPUFactors<scalar_t>> gpu_factors_;
+    std::unique_ptr<FactorStore<scalar_t>> factor_store_;
+
+    void setup_factor_store(const SPOptions<scalar_t>& opts);
 
   private:
     std::unique_ptr<F_t>
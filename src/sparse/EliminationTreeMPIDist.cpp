@@ -33,6 +33,7 @@
 #include "ordering/MatrixReorderingMPI.hpp"
 #include "fronts/FrontalMatrix.hpp"
 #include "fronts/FrontalMatrixMPI.hpp"
+#include "fronts/FrontalMatrixDense.hpp"
 
 namespace strumpack {
 
@@ -224,129 +225,141 @@ namespace strumpack {
   EliminationTreeMPIDist<scalar_t,integer_t>::multifrontal_factorization
   (const CompressedSparseMatrix<scalar_t,integer_t>& A,
    const Opts_t& opts) {
+    this->setup_factor_store(opts);
     this->root_->multifrontal_factorization(Aprop_, opts);
+    // free the contribution blocks cached during the factorization
+    FrontalMatrixDense<scalar_t,integer_t>::CB_pool().clear();
+    if (this->factor_store_) this->factor_store_->wait();
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTreeMPIDist<scalar_t,integer_t>::factor_store_failed() const {
+    return comm_.all_reduce
+      (int(EliminationTree<scalar_t,integer_t>::factor_store_failed()),
+       MPI_MAX);
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTreeMPIDist<scalar_t,integer_t>::factor_failed() const {
+    return comm_.all_reduce
+      (int(EliminationTree<scalar_t,integer_t>::factor_failed()),
+       MPI_MAX);
+  }
+
+  /**
+   * Set up the communication pattern to redistribute the right-hand
+   * side from the 1d block row distribution dist to the (local)
+   * subtrees and the 2d block-cyclic distributed separators, and
+   * back. The global indices are communicated only here, so later
+   * solves only need to send the values.
+   */
   template<typename scalar_t,typename integer_t> void
-  EliminationTreeMPIDist<scalar_t,integer_t>::multifrontal_solve_dist
-  (DenseM_t& x, const std::vector<integer_t>& dist) {
+  EliminationTreeMPIDist<scalar_t,integer_t>::setup_solve_plan
+  (integer_t n, const std::vector<integer_t>& dist) {
+    auto& sp = solve_plan_;
     integer_t B = DistM_t::default_MB;
     integer_t lo = dist[rank_];
-    integer_t m = dist[rank_+1] - lo, n = x.cols();
-
-    std::unique_ptr<int[]> iwork(new int[4*P_]);
-    auto ibuf = iwork.get();
-    auto scnts = ibuf;
-    auto rcnts = ibuf + P_;
-    auto sdispls = ibuf + 2*P_;
-    auto rdispls = ibuf + 3*P_;
-
-    using Triplet = Triplet<scalar_t,integer_t>;
-    std::vector<Triplet> sbuf(m*n);
-    std::fill(scnts, scnts+P_, 0);
-    if (n == 1)
-      for (integer_t r=0; r<m; r++)
-        scnts[row_owner_[r]]++;
-    else {
-      for (integer_t r=0; r<m; r++) {
-        int pf = row_pfront_[nd_.perm()[r+lo]];
-        if (pf < 0) scnts[row_owner_[r]] += n;
-        else {
-          auto& f = all_pfronts_[pf];
-          for (integer_t c=0; c<n; c++)
-            scnts[row_owner_[r]+((c/B)%f.pcols)*f.prows]++;
-        }
-      }
-    }
+    integer_t m = dist[rank_+1] - lo;
+    sp.n = n;
+    sp.dist = dist;
+    sp.scnts.assign(P_, 0);
+    sp.rcnts.assign(P_, 0);
+    sp.sdispls.assign(P_, 0);
+    sp.rdispls.assign(P_, 0);
+    // destination of element (r,c) of x is
+    //   row_owner_[r] + ((c/B)%pcols)*prows
+    // for a separator of a distributed front, else row_owner_[r]
+    auto dest = [&](integer_t r, integer_t permr, integer_t c) -> int {
+      int pf = row_pfront_[permr];
+      if (pf < 0) return row_owner_[r];
+      auto& f = all_pfronts_[pf];
+      return row_owner_[r] + int((c/B)%f.pcols)*f.prows;
+    };
+    const auto perm = nd_.perm().data() + lo;
+    for (integer_t r=0; r<m; r++)
+      for (integer_t c=0; c<n; c++)
+        sp.scnts[dest(r, perm[r], c)]++;
     std::vector<std::size_t> pp(P_);
-    sdispls[0] = 0;
-    pp[0] = 0;
     for (int p=1; p<P_; p++)
-      pp[p] = sdispls[p] = sdispls[p-1] + scnts[p-1];
-    if (n == 1) {
-      const auto perm = nd_.perm().data() + lo;
-      for (integer_t r=0; r<m; r++)
-        sbuf[pp[row_owner_[r]]++] = {perm[r], 0, x(r,0)};
-    } else {
-      for (integer_t r=0; r<m; r++) {
-        auto destr = row_owner_[r];
-        auto permr = nd_.perm()[r+lo];
-        int pf = row_pfront_[permr];
-        if (pf < 0)
-          for (integer_t c=0; c<n; c++)
-            sbuf[pp[destr]++] = {permr, c, x(r,c)};
-        else {
-          auto& f = all_pfronts_[pf];
-          for (integer_t c=0; c<n; c++)
-            sbuf[pp[destr+((c/B)%f.pcols)*f.prows]++] =
-              {permr, c, x(r,c)};
-        }
+      pp[p] = sp.sdispls[p] = sp.sdispls[p-1] + sp.scnts[p-1];
+    std::size_t ssize = std::size_t(m)*n;
+    sp.srow.resize(ssize);
+    sp.scol.resize(ssize);
+    std::vector<integer_t> sgr(ssize);
+    for (integer_t r=0; r<m; r++)
+      for (integer_t c=0; c<n; c++) {
+        auto i = pp[dest(r, perm[r], c)]++;
+        sp.srow[i] = r;
+        sp.scol[i] = c;
+        sgr[i] = perm[r];
       }
-    }
-    comm_.all_to_all(scnts, 1, rcnts);
-    rdispls[0] = 0;
+    comm_.all_to_all(sp.scnts.data(), 1, sp.rcnts.data());
     for (int p=1; p<P_; p++)
-      rdispls[p] = rdispls[p-1] + rcnts[p-1];
-
-    auto rbuf = comm_.all_to_allv
-      (sbuf.data(), scnts, sdispls, rcnts, rdispls);
-
-    DenseM_t xloc(local_range_.second - local_range_.first, n);
-    DenseMW_t Xloc
-      (Aprop_.size(), n, xloc.data()-local_range_.first, xloc.ld());
-    std::vector<DistM_t> xdist(local_pfronts_.size());
-
+      sp.rdispls[p] = sp.rdispls[p-1] + sp.rcnts[p-1];
+    auto rgr = comm_.all_to_allv
+      (sgr.data(), sp.scnts.data(), sp.sdispls.data(),
+       sp.rcnts.data(), sp.rdispls.data());
+    auto rgc = comm_.all_to_allv
+      (sp.scol.data(), sp.scnts.data(), sp.sdispls.data(),
+       sp.rcnts.data(), sp.rdispls.data());
+    sp.xloc = DenseM_t(local_range_.second - local_range_.first, n);
+    sp.xdist.resize(local_pfronts_.size());
     for (std::size_t f=0; f<local_pfronts_.size(); f++)
-      xdist[f] = DistM_t
+      sp.xdist[f] = DistM_t
         (local_pfronts_[f].grid, local_pfronts_[f].dim_sep(), n);
-    auto rsize = rbuf.size();
+    auto rsize = rgr.size();
+    sp.rptr.resize(rsize);
 #pragma omp parallel for
     for (std::size_t i=0; i<rsize; i++) {
-      integer_t r = rbuf[i].r, c = rbuf[i].c;
+      integer_t r = rgr[i], c = rgc[i];
       if (r >= local_range_.first && r < local_range_.second)
-        Xloc(r, c) = rbuf[i].v;
+        sp.rptr[i] = &sp.xloc(r - local_range_.first, c);
       else {
         for (std::size_t f=0; f<local_pfronts_.size(); f++)
           if (r >= local_pfronts_[f].sep_begin &&
               r < local_pfronts_[f].sep_end) {
-            xdist[f].global(r - local_pfronts_[f].sep_begin, c) = rbuf[i].v;
+            sp.rptr[i] = &sp.xdist[f].global
+              (r - local_pfronts_[f].sep_begin, c);
             break;
           }
       }
     }
+    sp.sbuf.resize(ssize);
+    sp.rbuf.resize(rsize);
+  }
 
-    this->root_->multifrontal_solve(Xloc, xdist.data());
-
-    rcnts = ibuf;
-    scnts = ibuf + P_;
-    rdispls = ibuf + 2*P_;
-    sdispls = ibuf + 3*P_;
-    for (int p=0; p<P_; p++)
-      pp[p] = sdispls[p];
-    for (integer_t r=local_range_.first; r<local_range_.second; r++) {
-      auto dest = std::upper_bound
-        (dist.begin(), dist.end(), nd_.iperm()[r])-dist.begin()-1;
-      auto permgr = nd_.iperm()[r];
-      for (integer_t c=0; c<n; c++)
-        rbuf[pp[dest]++] = {permgr, c, Xloc(r,c)};
-    }
-    for (std::size_t i=0; i<local_pfronts_.size(); i++) {
-      if (xdist[i].lcols() == 0) continue;
-      auto slo = local_pfronts_[i].sep_begin;
-      for (int r=0; r<xdist[i].lrows(); r++) {
-        auto permgr = nd_.iperm()[xdist[i].rowl2g(r) + slo];
-        auto dest = std::upper_bound
-          (dist.begin(), dist.end(), permgr)-dist.begin()-1;
-        for (int c=0; c<xdist[i].lcols(); c++)
-          rbuf[pp[dest]++] = {permgr, xdist[i].coll2g(c), xdist[i](r,c)};
-      }
-    }
+  template<typename scalar_t,typename integer_t> void
+  EliminationTreeMPIDist<scalar_t,integer_t>::multifrontal_solve_dist
+  (DenseM_t& x, const std::vector<integer_t>& dist) {
+    integer_t n = x.cols();
+    if (solve_plan_.n != n || solve_plan_.dist != dist)
+      setup_solve_plan(n, dist);
+    auto& sp = solve_plan_;
+    const std::size_t ssize = sp.sbuf.size(), rsize = sp.rbuf.size();
+#pragma omp parallel for
+    for (std::size_t i=0; i<ssize; i++)
+      sp.sbuf[i] = x(sp.srow[i], sp.scol[i]);
     comm_.all_to_allv
-      (rbuf.data(), scnts, sdispls, sbuf.data(), rcnts, rdispls);
+      (sp.sbuf.data(), sp.scnts.data(), sp.sdispls.data(),
+       sp.rbuf.data(), sp.rcnts.data(), sp.rdispls.data());
+#pragma omp parallel for
+    for (std::size_t i=0; i<rsize; i++)
+      *sp.rptr[i] = sp.rbuf[i];
 
+    DenseMW_t Xloc
+      (Aprop_.size(), n, sp.xloc.data()-local_range_.first, sp.xloc.ld());
+    this->root_->multifrontal_solve(Xloc, sp.xdist.data());
+
+    // the way back is the transpose of the forward communication
+#pragma omp parallel for
+    for (std::size_t i=0; i<rsize; i++)
+      sp.rbuf[i] = *sp.rptr[i];
+    comm_.all_to_allv
+      (sp.rbuf.data(), sp.rcnts.data(), sp.rdispls.data(),
+       sp.sbuf.data(), sp.scnts.data(), sp.sdispls.data());
 #pragma omp parallel for
-    for (std::size_t i=0; i<std::size_t(m)*n; i++)
-      x(sbuf[i].r-lo,sbuf[i].c) = sbuf[i].v;
+    for (std::size_t i=0; i<ssize; i++)
+      x(sp.srow[i], sp.scol[i]) = sp.sbuf[i];
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -67,6 +67,9 @@ namespace strumpack {
     void multifrontal_solve_dist
     (DenseM_t& x, const std::vector<integer_t>& dist) override;
 
+    bool factor_store_failed() const override;
+    bool factor_failed() const override;
+
     std::tuple<int,int,int> get_sparse_mapped_destination
     (const CSRMPI_t& A, integer_t oi, integer_t oj,
      integer_t i, integer_t j, bool duplicate_fronts) const;
@@ -135,6 +138,27 @@ namespace strumpack {
         is active. */
     std::vector<ParallelFront> all_pfronts_, local_pfronts_;
 
+    /**
+     * Communication plan for multifrontal_solve_dist. This only
+     * depends on the tree, the distribution of the right-hand side
+     * and the number of columns, so it is computed on the first solve
+     * and reused. Only the values are communicated, the indices are
+     * stored here.
+     */
+    struct SolvePlan {
+      integer_t n = 0; // number of right-hand side columns
+      std::vector<integer_t> dist;
+      std::vector<int> scnts, sdispls, rcnts, rdispls;
+      // row and column in the (local) x for each value sent
+      std::vector<integer_t> srow, scol;
+      // location in xloc or xdist for each value received
+      std::vector<scalar_t*> rptr;
+      DenseM_t xloc;
+      std::vector<DistM_t> xdist;
+      std::vector<scalar_t> sbuf, rbuf;
+    } solve_plan_;
+    void setup_solve_plan(integer_t n, const std::vector<integer_t>& dist);
+
     void symbolic_factorization
     (std::vector<std::vector<integer_t>>& local_upd,
      std::vector<float>& local_subtree_work,
@@ -151,25 +151,21 @@ namespace strumpack {
    const std::vector<std::size_t>& J, DenseM_t& B, int depth) const {
     integer_t m = I.size(), n = J.size();
     if (m == 0 || n == 0) return;
+    B.zero();
+    // sort I once, then merge it with the (sorted) row indices of
+    // each local column
+    const auto pI = this->sorted_order(I);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(64)      \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
     for (integer_t j=0; j<n; j++) {
       integer_t c = find_global(J[j]);
-      if (c == local_cols_ || global_col_[c] != integer_t(J[j])) {
-        std::fill(B.ptr(0,j), B.ptr(m, j), scalar_t(0.));
-        continue;
-      }
-      auto rmin = ind_[ptr_[c]];
-      auto rmax = ind_[ptr_[c+1]-1];
-      for (integer_t i=0; i<m; i++) {
-        integer_t r = I[i];
-        if (r >= rmin && r <= rmax &&
-            (global_col_[c] < shi || r < shi)) {
-          auto a_pos = ptr_[c];
-          auto a_max = ptr_[c+1];
-          while (a_pos < a_max-1 && ind_[a_pos] < r) a_pos++;
-          B(i,j) = (ind_[a_pos] == r) ?
-            val_[a_pos] : scalar_t(0.);
-        } else B(i,j) = scalar_t(0.);
-      }
+      if (c == local_cols_ || global_col_[c] != integer_t(J[j])) continue;
+      this->merge_extract
+        (ptr_[c], ptr_[c+1], I, pI,
+         (global_col_[c] < shi) ? std::size_t(-1) : std::size_t(shi),
+         B.ptr(0, j), 1);
     }
   }
 
@@ -411,7 +407,9 @@ namespace strumpack {
         }
       }
     }
-    for (integer_t i=0; i<dim_upd; ++i) { // update columns
+    // F12 can be left empty (symmetric factorization)
+    integer_t du12 = F12.cols();
+    for (integer_t i=0; i<du12; ++i) { // update columns
       //while (c < local_cols_ && global_col_[c] < upd[i]) c++;
       c = find_global(upd[i], c);
       if (c == local_cols_ || global_col_[c] != upd[i]) continue;
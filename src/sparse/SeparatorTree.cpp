@@ -28,6 +28,7 @@
  */
 #include <stack>
 #include <fstream>
+#include <stdexcept>
 #include <iostream>
 #include <algorithm>
 #include <functional>
@@ -186,6 +187,69 @@ namespace strumpack {
   }
 #endif
 
+  template<typename integer_t> void
+  SeparatorTree<integer_t>::write(std::ofstream& os) const {
+    os.write((const char*)&nr_seps_, sizeof(nr_seps_));
+    os.write((const char*)sep_sizes_, size()*sizeof(integer_t));
+  }
+
+  template<typename integer_t> std::unique_ptr<SeparatorTree<integer_t>>
+  SeparatorTree<integer_t>::read(std::ifstream& is, integer_t n) {
+    integer_t nseps = 0;
+    is.read((char*)&nseps, sizeof(nseps));
+    // check the number of separators against the rest of the file
+    // before allocating anything
+    auto pos = is.tellg();
+    is.seekg(0, std::ios::end);
+    auto left = is.tellg() - pos;
+    is.seekg(pos);
+    if (!is || nseps < 0 ||
+        std::streamoff(4*std::size_t(nseps)+1) >
+        left / std::streamoff(sizeof(integer_t)))
+      throw std::runtime_error("Invalid separator tree in file");
+    std::unique_ptr<SeparatorTree<integer_t>> t
+      (new SeparatorTree<integer_t>(nseps));
+    is.read((char*)t->sep_sizes_, t->size()*sizeof(integer_t));
+    if (!is || !t->valid(n))
+      throw std::runtime_error("Invalid separator tree in file");
+    return t;
+  }
+
+  template<typename integer_t> bool
+  SeparatorTree<integer_t>::valid(integer_t n) const {
+    if (nr_seps_ == 0) return n == 0;
+    if (sep_sizes_[0] != 0 || sep_sizes_[nr_seps_] != n) return false;
+    integer_t roots = 0;
+    auto in_range = [&](integer_t s) { return s >= -1 && s < nr_seps_; };
+    for (integer_t i=0; i<nr_seps_; i++) {
+      auto pa = parent_[i], lc = lchild_[i], rc = rchild_[i];
+      if (sep_sizes_[i+1] < sep_sizes_[i] ||
+          !in_range(pa) || !in_range(lc) || !in_range(rc) ||
+          (lc == -1) != (rc == -1) || (lc != -1 && lc == rc))
+        return false;
+      if (pa == -1) roots++;
+      else if (lchild_[pa] != i && rchild_[pa] != i) return false;
+      if (lc != -1 && (parent_[lc] != i || parent_[rc] != i))
+        return false;
+    }
+    if (roots != 1) return false;
+    // every separator has a single parent, so the tree is connected
+    // (and without cycles) if all separators are reached from the root
+    integer_t visited = 0;
+    std::stack<integer_t> s;
+    s.push(root());
+    while (!s.empty()) {
+      auto i = s.top();
+      s.pop();
+      if (++visited > nr_seps_) return false;
+      if (lchild_[i] != -1) {
+        s.push(lchild_[i]);
+        s.push(rchild_[i]);
+      }
+    }
+    return visited == nr_seps_;
+  }
+
   template<typename integer_t> integer_t
   SeparatorTree<integer_t>::levels() const {
     if (nr_seps_) {
@@ -455,6 +519,80 @@ namespace strumpack {
     return top;
   }
 
+  template<typename integer_t> std::unique_ptr<SeparatorTree<integer_t>>
+  SeparatorTree<integer_t>::amalgamate
+  (const integer_t* ptr, const integer_t* ind,
+   const std::vector<integer_t>& perm, double tol) const {
+    integer_t n = perm.size();
+    std::vector<integer_t> iperm(n);
+    for (integer_t i=0; i<n; i++) iperm[perm[i]] = i;
+    // nodes are numbered in postorder, so children are visited
+    // before their parent, and the nodes of a subtree are contiguous
+    std::vector<std::vector<integer_t>> upd(nr_seps_);
+    std::vector<integer_t> first(nr_seps_);
+    std::vector<bool> merged(nr_seps_, false);
+    // nonzeros in the dense fronts of the original separators
+    std::vector<double> nnz(nr_seps_);
+    for (integer_t s=0; s<nr_seps_; s++) {
+      auto sep_end = sep_sizes_[s+1];
+      auto& u = upd[s];
+      for (integer_t c=sep_sizes_[s]; c<sep_end; c++) {
+        auto r = iperm[c];
+        for (integer_t j=ptr[r]; j<ptr[r+1]; j++) {
+          auto pj = perm[ind[j]];
+          if (pj >= sep_end) u.push_back(pj);
+        }
+      }
+      for (auto ch : {lchild_[s], rchild_[s]}) {
+        if (ch == -1) continue;
+        for (auto i : upd[ch])
+          if (i >= sep_end) u.push_back(i);
+        std::vector<integer_t>().swap(upd[ch]);
+      }
+      std::sort(u.begin(), u.end());
+      u.erase(std::unique(u.begin(), u.end()), u.end());
+      double ds = sep_end - sep_sizes_[s], du = u.size();
+      nnz[s] = ds * ds + 2. * ds * du;
+      first[s] = sep_sizes_[s];
+      auto l = lchild_[s], r = rchild_[s];
+      if (l == -1 || !(merged[l] || is_leaf(l)) ||
+          !(merged[r] || is_leaf(r)))
+        continue;
+      // try to merge the children, which are (merged) leaves, into s
+      double d = sep_end - first[l];
+      double mnnz = d * d + 2. * d * du;
+      double onnz = nnz[l] + nnz[r] + nnz[s];
+      if (mnnz - onnz <= tol * mnnz) {
+        merged[s] = true;
+        first[s] = first[l];
+        nnz[s] = onnz;
+      }
+    }
+    // a node is kept when none of its ancestors is merged
+    std::vector<bool> keep(nr_seps_, true);
+    for (integer_t s=nr_seps_-1; s>=0; s--)
+      if (!keep[s] || merged[s])
+        for (auto ch : {lchild_[s], rchild_[s]})
+          if (ch != -1) keep[ch] = false;
+    std::vector<integer_t> id(nr_seps_, -1);
+    integer_t nr_new = 0;
+    for (integer_t s=0; s<nr_seps_; s++)
+      if (keep[s]) id[s] = nr_new++;
+    std::unique_ptr<SeparatorTree<integer_t>> tree
+      (new SeparatorTree<integer_t>(nr_new));
+    tree->sep_sizes_[0] = 0;
+    for (integer_t s=0; s<nr_seps_; s++) {
+      if (!keep[s]) continue;
+      auto i = id[s];
+      tree->sep_sizes_[i+1] = sep_sizes_[s+1];
+      tree->parent_[i] = parent_[s] == -1 ? -1 : id[parent_[s]];
+      tree->lchild_[i] = merged[s] || lchild_[s] == -1 ? -1 : id[lchild_[s]];
+      tree->rchild_[i] = merged[s] || rchild_[s] == -1 ? -1 : id[rchild_[s]];
+    }
+    tree->check();
+    return tree;
+  }
+
   template<typename integer_t>
   std::unique_ptr<SeparatorTree<integer_t>> build_sep_tree_from_perm
   (const integer_t* ptr, const integer_t* ind,
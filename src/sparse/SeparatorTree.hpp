@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <memory>
+#include <fstream>
 #if defined(STRUMPACK_USE_MPI)
 #include "misc/MPIWrapper.hpp"
 #endif
@@ -82,6 +83,26 @@ namespace strumpack {
     std::unique_ptr<SeparatorTree<integer_t>> subtree(integer_t p, integer_t P) const;
     std::unique_ptr<SeparatorTree<integer_t>> toptree(integer_t P) const;
 
+    /**
+     * Construct a new tree where small subtrees are merged into a
+     * single leaf separator. A subtree is merged (bottom-up) if, in
+     * the dense front of the merged separator, the fraction of
+     * explicitly stored zeros (compared to the fronts of the
+     * original separators) is at most tol. Since the separators in
+     * a subtree are numbered contiguously, the permutation does not
+     * change.
+     *
+     * \param ptr row pointers of the (not permuted) graph, with
+     * symmetric sparsity pattern
+     * \param ind column indices of the (not permuted) graph
+     * \param perm fill reducing permutation, row i of the graph is
+     * row perm[i] of the permuted graph
+     * \param tol fraction of explicit zeros allowed in a merged front
+     */
+    std::unique_ptr<SeparatorTree<integer_t>> amalgamate
+    (const integer_t* ptr, const integer_t* ind,
+     const std::vector<integer_t>& perm, double tol) const;
+
     integer_t separators() const { return nr_seps_; }
 
     const integer_t* pa() const { return parent_; }
@@ -116,6 +137,27 @@ namespace strumpack {
     void broadcast(const MPIComm& c);
 #endif
 
+    /**
+     * Write this tree to a binary file stream.
+     */
+    void write(std::ofstream& os) const;
+
+    /**
+     * Read a tree, which was written with write, from a binary file
+     * stream. Throws a std::runtime_error if the data read from the
+     * stream is not a valid tree for a matrix with n rows.
+     */
+    static std::unique_ptr<SeparatorTree<integer_t>>
+    read(std::ifstream& is, integer_t n);
+
+    /**
+     * Check (also without NDEBUG) that this is a valid tree for a
+     * matrix with n rows: a single root, consistent parent/child
+     * links, 0 or 2 children per node and nondecreasing separator
+     * sizes ending at n.
+     */
+    bool valid(integer_t n) const;
+
   protected:
     integer_t nr_seps_ = 0;
     std::unique_ptr<integer_t[]> iwork_ = nullptr;
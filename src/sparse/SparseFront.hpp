@@ -0,0 +1,176 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ */
+#ifndef STRUMPACK_SPARSE_FRONT_HPP
+#define STRUMPACK_SPARSE_FRONT_HPP
+
+#include <vector>
+#include <cassert>
+
+#include "misc/Tools.hpp"
+#include "misc/Triplet.hpp"
+#include "dense/DenseMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * \class SparseFront
+   * \brief Sparse part of a frontal matrix, [F11 F12; F21 0], stored
+   * as a small local CSR matrix, and its transpose, to multiply with
+   * tall and skinny (random sample) matrices.
+   *
+   * The nonzeros are gathered once from the global sparse matrix, so
+   * the multiplication does not need to search for the update
+   * indices anymore. The dense matrix is multiplied in panels of
+   * (at most) 32 columns. Each panel is first copied to row major
+   * order, so that for each nonzero a contiguous row of the panel is
+   * read, in a loop with a compile time length that can be
+   * vectorized.
+   */
+  template<typename scalar_t,typename integer_t> class SparseFront {
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using Trip_t = Triplet<scalar_t,integer_t>;
+
+  public:
+    /**
+     * Blocks of the front to include, can be combined with |. The
+     * local numbering of the rows (columns) is: first the separator
+     * rows (columns), if F11 or F12 (F11 or F21) are included,
+     * followed by the update rows (columns), if F21 (F12) is
+     * included.
+     */
+    enum Blocks : int { F11 = 1, F12 = 2, F21 = 4, ALL = 7 };
+
+    SparseFront() {}
+
+    /**
+     * Construct an m x n sparse matrix from a list of nonzeros, with
+     * local row and column indices.
+     */
+    SparseFront(integer_t m, integer_t n, const std::vector<Trip_t>& e)
+      : m_(m), n_(n) {
+      to_csr(m, e, false, ptr_, ind_, val_);
+      to_csr(n, e, true, tptr_, tind_, tval_);
+    }
+
+    integer_t rows() const { return m_; }
+    integer_t cols() const { return n_; }
+    std::size_t nnz() const { return val_.size(); }
+
+    /**
+     * Compute S += op(F) R, with op N, T or C.
+     */
+    void multiply(Trans op, const DenseM_t& R, DenseM_t& S,
+                  int depth) const {
+      const bool tr = op != Trans::N;
+      const integer_t mo = tr ? n_ : m_, mi = tr ? m_ : n_;
+      assert(R.rows() >= std::size_t(mi) && S.rows() >= std::size_t(mo));
+      assert(R.cols() == S.cols());
+      const std::size_t d = R.cols();
+      if (!nnz() || !d) return;
+      const auto& ptr = tr ? tptr_ : ptr_;
+      const auto& ind = tr ? tind_ : ind_;
+      const auto& val = tr ? tval_ : val_;
+      const bool conj = op == Trans::C && is_complex<scalar_t>();
+      const std::size_t nbmax = 32;
+      std::vector<scalar_t> Rp(std::size_t(mi) * std::min(d, nbmax));
+      for (std::size_t c=0; c<d; ) {
+        std::size_t nb = std::min(d - c, nbmax);
+        if (nb < nbmax) nb = (nb >= 16) ? 16 : (nb >= 8) ? 8 :
+                           (nb >= 4) ? 4 : 1;
+        for (std::size_t k=0; k<nb; k++)
+          for (integer_t i=0; i<mi; i++)
+            Rp[i*nb+k] = R(i, c+k);
+        switch (nb) {
+        case 32: panel<32>(mo, ptr, ind, val, conj, Rp, S, c, depth); break;
+        case 16: panel<16>(mo, ptr, ind, val, conj, Rp, S, c, depth); break;
+        case 8:  panel<8>(mo, ptr, ind, val, conj, Rp, S, c, depth); break;
+        case 4:  panel<4>(mo, ptr, ind, val, conj, Rp, S, c, depth); break;
+        default: panel<1>(mo, ptr, ind, val, conj, Rp, S, c, depth);
+        }
+        c += nb;
+      }
+      STRUMPACK_FLOPS
+        ((is_complex<scalar_t>() ? 4 : 1) * 2 * (long long)(nnz()) * d);
+      STRUMPACK_SPARSE_SAMPLE_FLOPS
+        ((is_complex<scalar_t>() ? 4 : 1) * 2 * (long long)(nnz()) * d);
+    }
+
+  private:
+    integer_t m_ = 0, n_ = 0;
+    std::vector<integer_t> ptr_, ind_, tptr_, tind_;
+    std::vector<scalar_t> val_, tval_;
+
+    static void to_csr
+    (integer_t m, const std::vector<Trip_t>& e, bool trans,
+     std::vector<integer_t>& ptr, std::vector<integer_t>& ind,
+     std::vector<scalar_t>& val) {
+      ptr.assign(m+1, 0);
+      for (auto& t : e) ptr[(trans ? t.c : t.r)+1]++;
+      for (integer_t i=0; i<m; i++) ptr[i+1] += ptr[i];
+      std::vector<integer_t> pos(ptr.begin(), ptr.end()-1);
+      ind.resize(e.size());
+      val.resize(e.size());
+      for (auto& t : e) {
+        auto k = pos[trans ? t.c : t.r]++;
+        ind[k] = trans ? t.r : t.c;
+        val[k] = t.v;
+      }
+    }
+
+    /**
+     * S(:,c:c+NB) += F Rp, with Rp an NB wide row major panel.
+     */
+    template<int NB> static void panel
+    (integer_t m, const std::vector<integer_t>& ptr,
+     const std::vector<integer_t>& ind, const std::vector<scalar_t>& val,
+     bool conj, const std::vector<scalar_t>& Rp, DenseM_t& S,
+     std::size_t c, int depth) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(32)      \
+  if(depth < params::task_recursion_cutoff_level)
+#endif
+      for (integer_t i=0; i<m; i++) {
+        const auto hij = ptr[i+1];
+        if (ptr[i] == hij) continue;
+        scalar_t s[NB] = {};
+        for (auto j=ptr[i]; j<hij; j++) {
+          const auto v = conj ? blas::my_conj(val[j]) : val[j];
+          const auto r = &Rp[std::size_t(ind[j])*NB];
+#pragma omp simd
+          for (int k=0; k<NB; k++)
+            s[k] += v * r[k];
+        }
+        for (int k=0; k<NB; k++)
+          S(i, c+k) += s[k];
+      }
+    }
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_SPARSE_FRONT_HPP
@@ -295,6 +295,56 @@ namespace strumpack {
   }
 
 
+  template<typename scalar_t,typename integer_t> void
+  ExtendAdd<scalar_t,integer_t>::extend_add_recv_counts
+  (const DistM_t& F11, const DistM_t& F22, const FMPI_t* pa,
+   const F_t* ch, int master, VI_t& cnt) {
+    if (!(F11.active() || F22.active())) return;
+    const auto ch_dim_upd = ch->dim_upd();
+    const auto& ch_upd = ch->upd();
+    const auto& pa_upd = pa->upd();
+    const auto pa_sep = pa->sep_begin();
+    // a sequential child sends everything from its master rank
+    auto mpi_ch = dynamic_cast<const FMPI_t*>(ch);
+    const int prows = mpi_ch ? mpi_ch->grid()->nprows() : 1;
+    const int pcols = mpi_ch ? mpi_ch->grid()->npcols() : 1;
+    const auto B = DistM_t::default_MB;
+    // number of local rows (columns) of this front which come from
+    // each process row (column) in the grid of the child
+    VI_t hr(prows), hc(pcols);
+    for (int r=0, ur=0; r<F11.lrows(); r++) {
+      auto fgr = F11.rowl2g_fixed(r) + pa_sep;
+      while (ur < ch_dim_upd && ch_upd[ur] < fgr) ur++;
+      if (ur == ch_dim_upd) break;
+      if (ch_upd[ur] != fgr) continue;
+      hr[(ur / B) % prows]++;
+    }
+    for (int c=0, uc=0; c<F11.lcols(); c++) {
+      auto fgc = F11.coll2g_fixed(c) + pa_sep;
+      while (uc < ch_dim_upd && ch_upd[uc] < fgc) uc++;
+      if (uc == ch_dim_upd) break;
+      if (ch_upd[uc] != fgc) continue;
+      hc[(uc / B) % pcols]++;
+    }
+    for (int r=0, ur=0; r<F22.lrows(); r++) {
+      auto fgr = pa_upd[F22.rowl2g_fixed(r)];
+      while (ur < ch_dim_upd && ch_upd[ur] < fgr) ur++;
+      if (ur == ch_dim_upd) break;
+      if (ch_upd[ur] != fgr) continue;
+      hr[(ur / B) % prows]++;
+    }
+    for (int c=0, uc=0; c<F22.lcols(); c++) {
+      auto fgc = pa_upd[F22.coll2g_fixed(c)];
+      while (uc < ch_dim_upd && ch_upd[uc] < fgc) uc++;
+      if (uc == ch_dim_upd) break;
+      if (ch_upd[uc] != fgc) continue;
+      hc[(uc / B) % pcols]++;
+    }
+    for (int pc=0; pc<pcols; pc++)
+      for (int pr=0; pr<prows; pr++)
+        cnt[master+pr+pc*prows] += hr[pr] * hc[pc];
+  }
+
   template<typename scalar_t,typename integer_t> void
   ExtendAdd<scalar_t,integer_t>::extend_add_column_copy_to_buffers
   (const DistM_t& CB, VVS_t& sbuf, const FMPI_t* pa, const VI_t& I) {
@@ -61,6 +61,17 @@ namespace strumpack {
     (DistM_t& F11, DistM_t& F12, DistM_t& F21, DistM_t& F22,
      scalar_t** pbuf, const FMPI_t* pa, const FMPI_t* ch);
 
+    /*
+     * Count the number of elements of the contribution block of
+     * child ch that this rank of the parent pa receives from each
+     * rank of pa. Counts are added to cnt (size pa->P()), master is
+     * the rank of the first process of ch in pa. This matches the
+     * order used by extend_add(_seq)_copy_from_buffers.
+     */
+    static void extend_add_recv_counts
+    (const DistM_t& F11, const DistM_t& F22, const FMPI_t* pa,
+     const F_t* ch, int master, VI_t& cnt);
+
     static void extend_add_column_copy_to_buffers
     (const DistM_t& CB, VVS_t& sbuf, const FMPI_t* pa, const VI_t& I);
 
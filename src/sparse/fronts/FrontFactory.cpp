@@ -33,6 +33,7 @@
 
 #include "sparse/CSRGraph.hpp"
 #include "FrontalMatrixDense.hpp"
+#include "FrontalMatrixDenseSym.hpp"
 #include "FrontalMatrixHSS.hpp"
 #include "FrontalMatrixBLR.hpp"
 #if defined(STRUMPACK_USE_BPACK)
@@ -65,7 +66,12 @@ namespace strumpack {
     std::unique_ptr<FrontalMatrix<scalar_t,integer_t>> front;
     switch (opts.compression()) {
     case CompressionType::NONE: {
-      if (is_GPU(opts)) {
+      if (opts.symmetric_factorization()) {
+        front.reset
+          (new FrontalMatrixDenseSym<scalar_t,integer_t>
+           (s, sbegin, send, upd, opts.factorization()));
+        if (root) fc.dense++;
+      } else if (is_GPU(opts)) {
 #if defined(STRUMPACK_USE_CUDA) || defined(STRUMPACK_USE_HIP)
         front.reset
           (new FrontalMatrixGPU<scalar_t,integer_t>(s, sbegin, send, upd));
@@ -105,8 +111,16 @@ namespace strumpack {
 #endif
       }
     } break;
-    case CompressionType::LOSSLESS: // not implemented yet, use DenseMPI
-      break;
+    case CompressionType::LOSSLESS: {
+      if (is_lossless(dsep, dupd, compressed_parent, opts)) {
+#if defined(STRUMPACK_USE_ZFP)
+        front.reset
+          (new FrontalMatrixLossless<scalar_t,integer_t>
+           (s, sbegin, send, upd));
+        if (root) fc.lossless++;
+#endif
+      }
+    } break;
     };
     if (!front) {
       // fallback in case support for cublas/zfp/hodlr is missing
@@ -220,7 +234,7 @@ namespace strumpack {
       }
     } break;
     case CompressionType::LOSSY: // handled in DenseMPI
-    case CompressionType::LOSSLESS: // not implemented yet, use DenseMPI
+    case CompressionType::LOSSLESS: // handled in DenseMPI
     case CompressionType::NONE: break;
     };
     // (NONE, LOSSLESS, LOSSY or not compiled with HODLR)
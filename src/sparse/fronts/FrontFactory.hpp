@@ -41,13 +41,15 @@
 namespace strumpack {
 
   struct FrontCounter {
-    int dense, HSS, BLR, HODLR, lossy;
-    FrontCounter() : dense(0), HSS(0), BLR(0), HODLR(0), lossy(0) {}
+    int dense, HSS, BLR, HODLR, lossy, lossless;
+    FrontCounter() :
+      dense(0), HSS(0), BLR(0), HODLR(0), lossy(0), lossless(0) {}
     FrontCounter(int* c) :
-      dense(c[0]), HSS(c[1]), BLR(c[2]), HODLR(c[3]), lossy(c[4]) {}
+      dense(c[0]), HSS(c[1]), BLR(c[2]), HODLR(c[3]), lossy(c[4]),
+      lossless(c[5]) {}
 #if defined(STRUMPACK_USE_MPI)
     FrontCounter reduce(const MPIComm& comm) const {
-      std::array<int,5> w = {dense, HSS, BLR, HODLR, lossy};
+      std::array<int,6> w = {dense, HSS, BLR, HODLR, lossy, lossless};
       comm.reduce(w.data(), w.size(), MPI_SUM);
       return FrontCounter(w.data());
     }
@@ -96,6 +98,16 @@ namespace strumpack {
        dsep + dupd >= opts.compression_min_front_size());
 #else
     return false;
+#endif
+  }
+  template<typename scalar_t> bool is_lossless
+  (int dsep, int dupd, bool, const SPOptions<scalar_t>& opts) {
+#if defined(STRUMPACK_USE_ZFP)
+    return opts.compression() == CompressionType::LOSSLESS &&
+      (dsep >= opts.compression_min_sep_size() ||
+       dsep + dupd >= opts.compression_min_front_size());
+#else
+    return false;
 #endif
   }
   template<typename scalar_t> bool is_compressed
@@ -105,7 +117,8 @@ namespace strumpack {
       (is_HSS(dsep, dupd, compressed_parent, opts) ||
        is_BLR(dsep, dupd, compressed_parent, opts) ||
        is_HODLR(dsep, dupd, compressed_parent, opts) ||
-       is_lossy(dsep, dupd, compressed_parent, opts));
+       is_lossy(dsep, dupd, compressed_parent, opts) ||
+       is_lossless(dsep, dupd, compressed_parent, opts));
   }
 
   // forward definition
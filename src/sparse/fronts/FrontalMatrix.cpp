@@ -31,6 +31,7 @@
 #include <random>
 #include <vector>
 #include <cmath>
+#include <stdexcept>
 
 #include "FrontalMatrix.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -291,6 +292,18 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrix<scalar_t,integer_t>::write_factors(std::ofstream& os) const {
+    throw std::runtime_error
+      ("Writing the factors is not supported for " + type());
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrix<scalar_t,integer_t>::read_factors(std::ifstream& is) {
+    throw std::runtime_error
+      ("Reading the factors is not supported for " + type());
+  }
+
   template<typename scalar_t,typename integer_t> long long
   FrontalMatrix<scalar_t,integer_t>::factor_nonzeros(int task_depth) const {
     long long nnz = node_factor_nonzeros(), nnzl = 0, nnzr = 0;
@@ -539,6 +552,45 @@ namespace strumpack {
     } else ldata.push_back(this);
   }
 
+  /**
+   * Estimate the number of flops for the factorization of the
+   * subtree rooted at this front, assuming all fronts are dense:
+   * LU of F11, the two triangular solves, the Schur complement
+   * update and the extend-add.
+   */
+  template<typename scalar_t,typename integer_t> double
+  FrontalMatrix<scalar_t,integer_t>::map_subtree_flops() {
+    const double ds = dim_sep(), du = dim_upd();
+    subtree_flops_ = 2./3.*ds*ds*ds + 2.*ds*ds*du + 2.*ds*du*du + du*du;
+    if (lchild_) subtree_flops_ += lchild_->map_subtree_flops();
+    if (rchild_) subtree_flops_ += rchild_->map_subtree_flops();
+    return subtree_flops_;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrix<scalar_t,integer_t>::map_threads(double P) {
+    map_subtree_flops();
+    assign_threads(P);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrix<scalar_t,integer_t>::assign_threads(double P) {
+    threads_ = P;
+    const double fl = lchild_ ? lchild_->subtree_flops_ : 0.,
+      fr = rchild_ ? rchild_->subtree_flops_ : 0.;
+    if (fl + fr == 0.) return;
+    if (lchild_) lchild_->assign_threads(P * fl / (fl + fr));
+    if (rchild_) rchild_->assign_threads(P * fr / (fl + fr));
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  FrontalMatrix<scalar_t,integer_t>::child_task_depth
+  (const F_t* ch, int task_depth) const {
+    if (!ch || threads_ == 0.) return task_depth + 1;
+    return (ch->threads_ > 1.) ?
+      std::min(task_depth + 1, params::task_recursion_cutoff_level - 1) :
+      params::task_recursion_cutoff_level;
+  }
 
   // explicit template instantiations
   template class FrontalMatrix<float,int>;
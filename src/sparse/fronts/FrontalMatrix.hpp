@@ -33,11 +33,14 @@
 #include <vector>
 #include <cmath>
 #include <typeinfo>
+#include <fstream>
 
 #include "StrumpackParameters.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/FrontTrace.hpp"
 #include "dense/DenseMatrix.hpp"
 #include "sparse/CompressedSparseMatrix.hpp"
+#include "misc/FactorStore.hpp"
 #if defined(_OPENMP)
 #include "omp.h"
 #endif
@@ -84,6 +87,7 @@ namespace strumpack {
      integer_t sep_end, std::vector<integer_t>& upd);
     virtual ~FrontalMatrix() = default;
 
+    integer_t sep() const { return sep_; }
     integer_t sep_begin() const { return sep_begin_; }
     integer_t sep_end() const { return sep_end_; }
     integer_t dim_sep() const { return sep_end_ - sep_begin_; }
@@ -102,6 +106,41 @@ namespace strumpack {
 
     virtual void release_work_memory() = 0;
 
+    // whether the factorization of a front in this subtree failed,
+    // fronts which do not detect failures rely on pivot replacement
+    virtual bool factor_failed() const {
+      return (lchild_ && lchild_->factor_failed()) ||
+        (rchild_ && rchild_->factor_failed());
+    }
+
+    // fronts supporting out-of-core storage write their factors to
+    // this store after the factorization. next is the front that
+    // follows this one in postorder (nullptr for the root), its
+    // factors are read ahead during the forward solve.
+    virtual void set_factor_store(FactorStore<scalar_t>* store,
+                                  const F_t* next=nullptr) {
+      if (lchild_)
+        lchild_->set_factor_store
+          (store, rchild_ ? rchild_->first_in_postorder() : this);
+      if (rchild_) rchild_->set_factor_store(store, this);
+    }
+    // start reading the out-of-core factors ahead of the solve. With
+    // forward, nothing is done if this front already completed its
+    // forward solve, since it can run concurrently with the front
+    // requesting the prefetch.
+    virtual void prefetch_factors(bool forward=false) const {}
+    const F_t* first_in_postorder() const {
+      auto f = this;
+      while (f->lchild_ || f->rchild_)
+        f = f->lchild_ ? f->lchild_.get() : f->rchild_.get();
+      return f;
+    }
+
+    // write/read the factors of this front and its descendants to a
+    // binary stream, see StrumpackSparseSolver::save_factors
+    virtual void write_factors(std::ofstream& os) const;
+    virtual void read_factors(std::ifstream& is);
+
     virtual void
     multifrontal_factorization(const SpMat_t& A, const Opts_t& opts,
                                int etree_level=0, int task_depth=0) = 0;
@@ -214,6 +253,26 @@ namespace strumpack {
 
     virtual int P() const { return 1; }
 
+    /**
+     * Proportional mapping of the threads to the subtrees: P threads
+     * are assigned to the subtree rooted at this front, and are
+     * divided over the children proportionally to the estimated
+     * number of flops for the factorization of their subtrees. This
+     * is used by child_task_depth.
+     */
+    void map_threads(double P);
+    /**
+     * Task depth to use for child ch of this front, during the
+     * factorization, when called with task_depth. Without thread
+     * mapping, this is task_depth+1, so tasks are created up to a
+     * fixed depth params::task_recursion_cutoff_level. With thread
+     * mapping, tasks are created (and the dense kernels in the
+     * front use nested task parallelism) as long as more than one
+     * thread is assigned to the subtree, subtrees mapped to at most
+     * one thread are handled sequentially, whatever their depth.
+     */
+    int child_task_depth(const F_t* ch, int task_depth) const;
+
     void get_level_fronts(std::vector<const F_t*>& ldata, int elvl, int l=0) const;
     void get_level_fronts(std::vector<F_t*>& ldata, int elvl, int l=0);
 
@@ -299,6 +358,7 @@ namespace strumpack {
     integer_t sep_, sep_begin_, sep_end_;
     std::vector<integer_t> upd_;
     std::unique_ptr<F_t> lchild_, rchild_;
+    double threads_ = 0.; // threads mapped to this subtree, 0 if unset
 
     virtual long long node_factor_nonzeros() const {
       return dense_node_factor_nonzeros();
@@ -309,6 +369,10 @@ namespace strumpack {
      bool is_root=true, int task_depth=0);
 
   private:
+    double subtree_flops_ = 0.; // estimate, used for thread mapping
+    double map_subtree_flops();
+    void assign_threads(double P);
+
     FrontalMatrix(const FrontalMatrix&) = delete;
     FrontalMatrix& operator=(FrontalMatrix const&) = delete;
 
@@ -27,7 +27,10 @@
  *
  */
 
+#include <typeinfo>
+
 #include "FrontalMatrixDense.hpp"
+#include "FrontalMatrixDenseKernels.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontalMatrixMPI.hpp"
@@ -42,14 +45,228 @@ namespace strumpack {
    std::vector<integer_t>& upd)
     : F_t(nullptr, nullptr, sep, sep_begin, sep_end, upd) {}
 
+  template<typename scalar_t,typename integer_t> MemoryPool<scalar_t>&
+  FrontalMatrixDense<scalar_t,integer_t>::CB_pool() {
+    static MemoryPool<scalar_t> pool;
+    return pool;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::allocate_front(bool with_F12) {
+    const std::size_t dupd = dim_upd();
+    with_F12_ = with_F12;
+    const std::size_t fsize = factor_size();
+    factor_mem_ = MemoryPool<scalar_t>::allocate(fsize);
+    std::fill(factor_mem_.get(), factor_mem_.get()+fsize, scalar_t(0.));
+    set_factor_pointers();
+    if (dupd) {
+      CB_mem_ = CB_pool().get(dupd*dupd);
+      F22_ = DenseMW_t(dupd, dupd, CB_mem_.get(), dupd);
+      F22_.zero();
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> std::size_t
+  FrontalMatrixDense<scalar_t,integer_t>::factor_size() const {
+    const std::size_t dsep = dim_sep();
+    const std::size_t dupd = dim_upd();
+    return dsep * (dsep + (with_F12_ ? 2 : 1) * dupd);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::set_factor_pointers() const {
+    const std::size_t dsep = dim_sep();
+    const std::size_t dupd = dim_upd();
+    auto fmem = factor_mem_.get();
+    F11_ = DenseMW_t(dsep, dsep, fmem, dsep); fmem += dsep*dsep;
+    if (with_F12_) {
+      F12_ = DenseMW_t(dsep, dupd, fmem, dsep); fmem += dsep*dupd;
+    }
+    F21_ = DenseMW_t(dupd, dsep, fmem, dupd);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::release_factor_memory() {
+    F11_.clear();
+    F12_.clear();
+    F21_.clear();
+    factor_mem_.reset();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::release_work_memory() {
+    F22_.clear();
+    CB_pool().put(CB_mem_);
+    if (!use_maps_) std::vector<std::size_t>().swap(upd2pa_);
+  }
+
+  /**
+   * Copy the elements of the sparse matrix A to F11, F12 and F21
+   * (F12 is skipped when it is empty). With assembly maps enabled,
+   * the first call records where every nonzero goes, and later calls
+   * (after update_matrix_values) simply scatter the values, as long
+   * as the number of nonzeros did not change.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::assemble_from_sparse
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts, int task_depth) {
+    use_maps_ = opts.assembly_maps();
+    if (!use_maps_) {
+      A.extract_front
+        (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+         this->upd_, task_depth);
+      return;
+    }
+    if (Amap_nnz_ == A.nnz()) {
+      auto v = A.val();
+      DenseM_t* F[3] = {&F11_, &F12_, &F21_};
+      for (int b=0; b<3; b++) {
+        auto d = F[b]->data();
+        for (auto& e : Amap_[b])
+          d[e.second] = v[e.first];
+      }
+      return;
+    }
+    Amap_nnz_ = A.extract_front_map
+      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+       this->upd_, Amap_, task_depth) ? A.nnz() : -1;
+  }
+
+  /**
+   * Map from the update indices of this front to the parent p, see
+   * FrontalMatrix::upd_to_parent. With assembly maps enabled, this
+   * is only computed once.
+   */
+  template<typename scalar_t,typename integer_t>
+  const std::vector<std::size_t>&
+  FrontalMatrixDense<scalar_t,integer_t>::upd_to_parent_map
+  (const F_t* p, std::size_t& upd2sep) {
+    if (!use_maps_ || upd2pa_.size() != std::size_t(dim_upd()))
+      upd2pa_ = this->upd_to_parent(p, upd2sep_);
+    upd2sep = upd2sep_;
+    return upd2pa_;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::set_factor_store
+  (FactorStore<scalar_t>* store, const F_t* next) {
+    ooc_store_ = store;
+    ooc_next_ = next;
+    F_t::set_factor_store(store, next);
+  }
+
+  /**
+   * Write the factors to the out-of-core store and free them. If the
+   * write fails, the factors are kept in memory, and the failure is
+   * reported after the factorization, see FactorStore::failed.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::store_factors() {
+    if (!ooc_store_) return;
+    // the I/O thread frees the factors once they are written
+    ooc_store_->write
+      (factor_mem_.get(), factor_size(), ooc_rec_, [this]() {
+        std::lock_guard<std::mutex> lock(ooc_mtx_);
+        release_factor_memory();
+      });
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::prefetch_factors
+  (bool forward) const {
+    if (!ooc_store_) return;
+    std::lock_guard<std::mutex> lock(ooc_mtx_);
+    if (factor_mem_ || (forward && ooc_fwd_done_) ||
+        !ooc_store_->prefetch_allowed())
+      return;
+    factor_mem_ = MemoryPool<scalar_t>::allocate(ooc_rec_.size);
+    set_factor_pointers();
+    ooc_fetch_ = ooc_store_->read(ooc_rec_, factor_mem_.get());
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::load_factors() const {
+    if (!ooc_store_) return;
+    std::lock_guard<std::mutex> lock(ooc_mtx_);
+    if (!factor_mem_) {
+      factor_mem_ = MemoryPool<scalar_t>::allocate(ooc_rec_.size);
+      set_factor_pointers();
+      ooc_fetch_ = ooc_store_->read(ooc_rec_, factor_mem_.get());
+    }
+    if (ooc_fetch_.valid()) ooc_fetch_.get();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::unload_factors
+  (bool forward_done) const {
+    if (!ooc_store_) return;
+    std::lock_guard<std::mutex> lock(ooc_mtx_);
+    F11_.clear();
+    F12_.clear();
+    F21_.clear();
+    factor_mem_.reset();
+    ooc_fwd_done_ = forward_done;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::write_factors
+  (std::ofstream& os) const {
+    integer_t dims[2] = {dim_sep(), dim_upd()};
+    os.write((const char*)dims, sizeof(dims));
+    char F12 = with_F12_;
+    os.write(&F12, sizeof(F12));
+    std::size_t npiv = piv.size();
+    os.write((const char*)&npiv, sizeof(npiv));
+    os.write((const char*)piv.data(), npiv*sizeof(int));
+    // align the factors in the file, so they can be mapped directly
+    char pad[64] = {0};
+    os.write(pad, (64 - std::streamoff(os.tellp()) % 64) % 64);
+    load_factors();
+    os.write((const char*)factor_mem_.get(), factor_size()*sizeof(scalar_t));
+    unload_factors();
+    if (lchild_) lchild_->write_factors(os);
+    if (rchild_) rchild_->write_factors(os);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::read_factors(std::ifstream& is) {
+    integer_t dims[2];
+    is.read((char*)dims, sizeof(dims));
+    if (!is || dims[0] != dim_sep() || dims[1] != dim_upd())
+      throw std::runtime_error
+        ("Front dimensions in the factor file do not match");
+    char F12 = 1;
+    is.read(&F12, sizeof(F12));
+    with_F12_ = F12;
+    std::size_t npiv = 0;
+    is.read((char*)&npiv, sizeof(npiv));
+    if (!is || npiv > std::size_t(dim_sep()))
+      throw std::runtime_error("Invalid pivot vector in the factor file");
+    piv.resize(npiv);
+    is.read((char*)piv.data(), npiv*sizeof(int));
+    is.seekg((64 - std::streamoff(is.tellg()) % 64) % 64, std::ios::cur);
+    factor_mem_ = MemoryPool<scalar_t>::allocate(factor_size());
+    set_factor_pointers();
+    is.read((char*)factor_mem_.get(), factor_size()*sizeof(scalar_t));
+    if (!is)
+      throw std::runtime_error("Error reading the factor file");
+    store_factors();
+    if (lchild_) lchild_->read_factors(is);
+    if (rchild_) rchild_->read_factors(is);
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
    const F_t* p, int task_depth) {
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
+    FrontTraceScope trace
+      (FrontPhase::EXTEND_ADD, this, etree_level_,
+       (is_complex<scalar_t>()?2:1) * dupd * dupd,
+       dupd * dupd * sizeof(scalar_t));
     std::size_t upd2sep;
-    auto I = this->upd_to_parent(p, upd2sep);
+    const auto& I = upd_to_parent_map(p, upd2sep);
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)      \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -77,6 +294,16 @@ namespace strumpack {
   FrontalMatrixDense<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const SPOptions<scalar_t>& opts,
    int etree_level, int task_depth) {
+    if (opts.batch_front_size() > 0 && batchable(opts.batch_front_size())) {
+      if (task_depth == 0) {
+      // the single thread creates the taskloop tasks, the end of
+      // the parallel region waits for them
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+        factor_batched(A, opts, etree_level, task_depth);
+      } else factor_batched(A, opts, etree_level, task_depth);
+      return;
+    }
     if (task_depth == 0) {
       // use tasking for children and for extend-add parallelism
 #pragma omp parallel if(!omp_in_parallel()) default(shared)
@@ -89,6 +316,7 @@ namespace strumpack {
       factor_phase1(A, opts, etree_level, task_depth);
       factor_phase2(A, opts, etree_level, task_depth);
     }
+    store_factors();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -96,16 +324,16 @@ namespace strumpack {
   (const SpMat_t& A, const SPOptions<scalar_t>& opts,
    int etree_level, int task_depth) {
     if (task_depth < params::task_recursion_cutoff_level) {
+      const int dl = this->child_task_depth(lchild_.get(), task_depth),
+        dr = this->child_task_depth(rchild_.get(), task_depth);
       if (lchild_)
 #pragma omp task default(shared)                                        \
-  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        lchild_->multifrontal_factorization
-          (A, opts, etree_level+1, task_depth+1);
+  final(dl >= params::task_recursion_cutoff_level) mergeable
+        lchild_->multifrontal_factorization(A, opts, etree_level+1, dl);
       if (rchild_)
 #pragma omp task default(shared)                                        \
-  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        rchild_->multifrontal_factorization
-          (A, opts, etree_level+1, task_depth+1);
+  final(dr >= params::task_recursion_cutoff_level) mergeable
+        rchild_->multifrontal_factorization(A, opts, etree_level+1, dr);
 #pragma omp taskwait
     } else {
       if (lchild_)
@@ -115,25 +343,21 @@ namespace strumpack {
         rchild_->multifrontal_factorization
           (A, opts, etree_level+1, task_depth);
     }
-    // TODO can we allocate the memory in one go??
-    const auto dsep = dim_sep();
-    const auto dupd = dim_upd();
-    F11_ = DenseM_t(dsep, dsep); F11_.zero();
-    F12_ = DenseM_t(dsep, dupd); F12_.zero();
-    F21_ = DenseM_t(dupd, dsep); F21_.zero();
-    A.extract_front
-      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
-       this->upd_, task_depth);
-    if (dupd) {
-      F22_ = DenseM_t(dupd, dupd);
-      F22_.zero();
+    etree_level_ = etree_level;
+    {
+      const std::size_t dupd = dim_upd();
+      FrontTraceScope trace
+        (FrontPhase::ASSEMBLY, this, etree_level, 0,
+         (factor_size() + dupd*dupd) * sizeof(scalar_t));
+      allocate_front();
+      assemble_from_sparse(A, opts, task_depth);
+      if (lchild_)
+        lchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
+      if (rchild_)
+        rchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
     }
-    if (lchild_)
-      lchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, task_depth);
-    if (rchild_)
-      rchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, task_depth);
     if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
   }
 
@@ -141,16 +365,46 @@ namespace strumpack {
   FrontalMatrixDense<scalar_t,integer_t>::factor_phase2
   (const SpMat_t& A, const SPOptions<scalar_t>& opts,
    int etree_level, int task_depth) {
+    const std::size_t dupd = dim_upd();
+    long long flops = LU_flops(F11_) +
+      gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F21_, F12_, scalar_t(1.)) +
+      trsm_flops(Side::L, scalar_t(1.), F11_, F12_) +
+      trsm_flops(Side::R, scalar_t(1.), F11_, F21_);
+    FrontTraceScope trace
+      (FrontPhase::FACTOR, this, etree_level, flops,
+       (factor_size() + dupd*dupd) * sizeof(scalar_t));
+    auto replace_tiny_pivots = [&]() {
+      auto thresh = opts.pivot_threshold();
+      for (std::size_t i=0; i<F11_.rows(); i++)
+        if (std::abs(F11_(i,i)) < thresh)
+          F11_(i,i) = (std::real(F11_(i,i)) < 0) ? -thresh : thresh;
+    };
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+    // only when not in a parallel region, so for the root front. Below
+    // the root, the parallel region would be inactive, and all tile
+    // tasks would run on the thread factoring this front.
+    if (dim_sep() && params::num_threads > 1 && !omp_in_parallel() &&
+        opts.tiled_front_size() > 0 &&
+        dim_sep() >= opts.tiled_front_size()) {
+      // large front, tiled LU with task dependencies, tiles of 256
+      piv.resize(dim_sep());
+      int info = 0;
+#pragma omp parallel default(shared)
+#pragma omp single nowait
+      info = cpu::factor_tiled_front
+        (dim_sep(), dupd, F11_.data(), F11_.ld(), F12_.data(), F12_.ld(),
+         F21_.data(), F21_.ld(), F22_.data(), F22_.ld(), piv.data(),
+         opts.replace_tiny_pivots(), opts.pivot_threshold(), 256);
+      // the panels with a zero pivot are already fixed, as in the
+      // untiled case also replace the tiny pivots of the other panels
+      if (info) replace_tiny_pivots();
+    } else
+#endif
     if (dim_sep()) {
       // TaskTimer t("FrontalMatrixDense_factor");
       // if (etree_level == 0 && opts.print_root_front_stats()) t.start();
       int info = F11_.LU(piv, task_depth);
-      if (info || opts.replace_tiny_pivots()) {
-        auto thresh = opts.pivot_threshold();
-        for (std::size_t i=0; i<F11_.rows(); i++)
-          if (std::abs(F11_(i,i)) < thresh)
-            F11_(i,i) = (std::real(F11_(i,i)) < 0) ? -thresh : thresh;
-      }
+      if (info || opts.replace_tiny_pivots()) replace_tiny_pivots();
       if (dim_upd()) {
         F12_.laswp(piv, true);
         trsm(Side::L, UpLo::L, Trans::N, Diag::U,
@@ -167,11 +421,121 @@ namespace strumpack {
       //             << " time = " << time << " sec" << std::endl;
       // }
     }
-    STRUMPACK_FULL_RANK_FLOPS
-      (LU_flops(F11_) +
-       gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F21_, F12_, scalar_t(1.)) +
-       trsm_flops(Side::L, scalar_t(1.), F11_, F12_) +
-       trsm_flops(Side::R, scalar_t(1.), F11_, F21_));
+    STRUMPACK_FULL_RANK_FLOPS(flops);
+  }
+
+  /**
+   * Check whether the subtree rooted at this front can be factored
+   * with factor_batched: all fronts should be regular dense LU
+   * fronts (not one of the derived classes), with a separator of at
+   * most max_dsep. The result is cached per front, so the recursive
+   * factorization, which calls this on every front from the root
+   * down, visits each front only once.
+   */
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixDense<scalar_t,integer_t>::batchable(int max_dsep) const {
+    if (batch_max_dsep_ == max_dsep) return batchable_;
+    bool b = dim_sep() <= std::min(max_dsep, 32) &&
+      typeid(*this) == typeid(FrontalMatrixDense<scalar_t,integer_t>);
+    for (auto ch : {lchild_.get(), rchild_.get()}) {
+      if (!b || !ch) continue;
+      auto dch = dynamic_cast<const FrontalMatrixDense<scalar_t,integer_t>*>(ch);
+      b = dch && dch->batchable(max_dsep);
+    }
+    batch_max_dsep_ = max_dsep;
+    batchable_ = b;
+    return b;
+  }
+
+  /**
+   * Factor the subtree rooted at this front level by level, starting
+   * from the leaves. All fronts on a level are independent, they are
+   * distributed over the threads with a taskloop, which avoids the
+   * overhead of creating a task for every small front. A taskloop
+   * waits for all its tasks (it has an implicit taskgroup), so all
+   * children are done before their parents are assembled.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::factor_batched
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+   int etree_level, int task_depth) {
+    std::vector<F_t*> fp;
+    for (int l=this->levels()-1; l>=0; l--) {
+      fp.clear();
+      this->get_level_fronts(fp, l);
+      const std::size_t nf = fp.size();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+      for (std::size_t f=0; f<nf; f++)
+        static_cast<FrontalMatrixDense<scalar_t,integer_t>*>(fp[f])->
+          factor_small(A, opts, etree_level+l);
+    }
+  }
+
+  /**
+   * Assemble and factor a single small front, the children should
+   * already be factored. This does not create any tasks, and uses
+   * the fixed size kernels from FrontalMatrixDenseKernels.hpp instead
+   * of BLAS/LAPACK.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::factor_small
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts, int etree_level) {
+    const int no_tasks = params::task_recursion_cutoff_level;
+    const int dsep = dim_sep(), dupd = dim_upd();
+    const long long bytes = (factor_size() + dupd*dupd) * sizeof(scalar_t);
+    etree_level_ = etree_level;
+    {
+      FrontTraceScope trace
+        (FrontPhase::ASSEMBLY, this, etree_level, 0, bytes);
+      allocate_front();
+      assemble_from_sparse(A, opts, no_tasks);
+      if (lchild_)
+        lchild_->extend_add_to_dense(F11_, F12_, F21_, F22_, this, no_tasks);
+      if (rchild_)
+        rchild_->extend_add_to_dense(F11_, F12_, F21_, F22_, this, no_tasks);
+    }
+    if (dsep > 32) {
+      // too large for the fixed size kernels, use BLAS/LAPACK
+      factor_phase2(A, opts, etree_level, no_tasks);
+      store_factors();
+      return;
+    }
+    long long flops = LU_flops(F11_) +
+      gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F21_, F12_, scalar_t(1.)) +
+      trsm_flops(Side::L, scalar_t(1.), F11_, F12_) +
+      trsm_flops(Side::R, scalar_t(1.), F11_, F21_);
+    {
+      FrontTraceScope trace
+        (FrontPhase::FACTOR, this, etree_level, flops, bytes);
+      if (dsep) {
+        piv.resize(dsep);
+        auto thresh = opts.pivot_threshold();
+        auto replace = opts.replace_tiny_pivots();
+        if (dsep <= 8)
+          cpu::factor_small_front<8>
+            (dsep, dupd, F11_.data(), F11_.ld(), F12_.data(), F12_.ld(),
+             F21_.data(), F21_.ld(), F22_.data(), F22_.ld(), piv.data(),
+             replace, thresh);
+        else if (dsep <= 16)
+          cpu::factor_small_front<16>
+            (dsep, dupd, F11_.data(), F11_.ld(), F12_.data(), F12_.ld(),
+             F21_.data(), F21_.ld(), F22_.data(), F22_.ld(), piv.data(),
+             replace, thresh);
+        else
+          cpu::factor_small_front<32>
+            (dsep, dupd, F11_.data(), F11_.ld(), F12_.data(), F12_.ld(),
+             F21_.data(), F21_.ld(), F22_.data(), F22_.ld(), piv.data(),
+             replace, thresh);
+      }
+    }
+    // the fixed size kernels do not go through the BLAS/LAPACK
+    // wrappers, which count the flops for the other fronts
+    STRUMPACK_FLOPS(flops);
+    STRUMPACK_FULL_RANK_FLOPS(flops);
+    store_factors();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -184,12 +548,19 @@ namespace strumpack {
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
       this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
+      load_factors();
+      // read the factors of the next front in postorder while this
+      // front is being solved
+      if (ooc_next_) ooc_next_->prefetch_factors(true);
       // no tasking for the root node computations, use system blas threading!
       fwd_solve_phase2(b, bupd, etree_level, params::task_recursion_cutoff_level);
     } else {
       this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
+      load_factors();
+      if (ooc_next_) ooc_next_->prefetch_factors(true);
       fwd_solve_phase2(b, bupd, etree_level, task_depth);
     }
+    unload_factors(true);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -217,16 +588,25 @@ namespace strumpack {
   FrontalMatrixDense<scalar_t,integer_t>::backward_multifrontal_solve
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
+    load_factors();
+    // read the factors of the children while this front is solved,
+    // when the children are solved one after the other, only the
+    // left child is next (in preorder)
+    if (lchild_) lchild_->prefetch_factors();
+    if (rchild_ && task_depth < params::task_recursion_cutoff_level)
+      rchild_->prefetch_factors();
     if (task_depth == 0) {
       // no tasking in blas routines, use system threaded blas instead
       bwd_solve_phase1
         (y, yupd, etree_level, params::task_recursion_cutoff_level);
+      unload_factors();
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
       // tasking when calling children
       this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
     } else {
       bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      unload_factors();
       this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
     }
   }
@@ -319,7 +699,7 @@ namespace strumpack {
       for (std::size_t r=0; r<u2s; r++)
         cR(r,c) = R(Ir[r],c);
     DenseM_t cS(u2s, Rcols);
-    DenseMW_t CB11(u2s, u2s, const_cast<DenseM_t&>(F22_), 0, 0);
+    DenseMW_t CB11(u2s, u2s, const_cast<DenseMW_t&>(F22_), 0, 0);
     gemm(op, Trans::N, scalar_t(1.), CB11, cR, scalar_t(0.), cS, task_depth);
     for (std::size_t c=0; c<Rcols; c++)
       for (std::size_t r=0; r<u2s; r++)
@@ -336,7 +716,7 @@ namespace strumpack {
     auto Ir = this->upd_to_parent(pa, u2s);
     auto pds = pa->dim_sep();
     auto Rcols = R.cols();
-    DenseMW_t CB12(u2s, dupd-u2s, const_cast<DenseM_t&>(F22_), 0, u2s);
+    DenseMW_t CB12(u2s, dupd-u2s, const_cast<DenseMW_t&>(F22_), 0, u2s);
     if (op == Trans::N) {
       DenseM_t cR(dupd-u2s, Rcols);
       for (std::size_t c=0; c<Rcols; c++)
@@ -371,7 +751,7 @@ namespace strumpack {
     auto Ir = this->upd_to_parent(pa, u2s);
     auto Rcols = R.cols();
     auto pds = pa->dim_sep();
-    DenseMW_t CB21(dupd-u2s, u2s, const_cast<DenseM_t&>(F22_), u2s, 0);
+    DenseMW_t CB21(dupd-u2s, u2s, const_cast<DenseMW_t&>(F22_), u2s, 0);
     if (op == Trans::N) {
       DenseM_t cR(u2s, Rcols);
       for (std::size_t c=0; c<Rcols; c++)
@@ -411,7 +791,7 @@ namespace strumpack {
       for (std::size_t r=u2s; r<dupd; r++)
         cR(r-u2s,c) = R(Ir[r]-pds,c);
     DenseM_t cS(dupd-u2s, Rcols);
-    DenseMW_t CB22(dupd-u2s, dupd-u2s, const_cast<DenseM_t&>(F22_), u2s, u2s);
+    DenseMW_t CB22(dupd-u2s, dupd-u2s, const_cast<DenseMW_t&>(F22_), u2s, u2s);
     gemm(op, Trans::N, scalar_t(1.), CB22, cR, scalar_t(0.), cS, task_depth);
     for (std::size_t c=0; c<Rcols; c++)
       for (std::size_t r=u2s; r<dupd; r++)
@@ -34,8 +34,10 @@
 #include <algorithm>
 #include <cmath>
 #include <random>
+#include <mutex>
 
 #include "FrontalMatrix.hpp"
+#include "misc/MemoryPool.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "FrontalMatrixBLRMPI.hpp"
 #endif
@@ -56,7 +58,12 @@ namespace strumpack {
     (integer_t sep, integer_t sep_begin, integer_t sep_end,
      std::vector<integer_t>& upd);
 
-    void release_work_memory() override { F22_.clear(); }
+    void release_work_memory() override;
+    void set_factor_store(FactorStore<scalar_t>* store,
+                          const F_t* next=nullptr) override;
+    void prefetch_factors(bool forward=false) const override;
+    void write_factors(std::ofstream& os) const override;
+    void read_factors(std::ifstream& is) override;
     void extend_add_to_dense
     (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
      const F_t* p, int task_depth) override;
@@ -98,6 +105,13 @@ namespace strumpack {
 
     std::string type() const override { return "FrontalMatrixDense"; }
 
+    /**
+     * Pool from which the contribution blocks (F22) of all dense
+     * fronts are allocated. This is cleared after the numerical
+     * factorization.
+     */
+    static MemoryPool<scalar_t>& CB_pool();
+
 #if defined(STRUMPACK_USE_MPI)
     void extend_add_copy_to_buffers
     (std::vector<std::vector<scalar_t>>& sbuf,
@@ -108,12 +122,57 @@ namespace strumpack {
 #endif
 
   protected:
-    DenseM_t F11_, F12_, F21_, F22_;
+    // F11, F12 and F21 are stored in one contiguous block of memory,
+    // F22 is stored in a block taken from CB_pool(). Both are counted
+    // in the memory statistics, see MemoryPool. In out-of-core mode,
+    // the factors are written to ooc_store_ after the factorization
+    // and read back during the (const) solve.
+    mutable typename MemoryPool<scalar_t>::Block factor_mem_;
+    typename MemoryPool<scalar_t>::Block CB_mem_;
+    mutable DenseMW_t F11_, F12_, F21_;
+    DenseMW_t F22_;
+    bool with_F12_ = true;
+    FactorStore<scalar_t>* ooc_store_ = nullptr;
+    typename FactorStore<scalar_t>::Record ooc_rec_;
+    mutable std::future<void> ooc_fetch_;
+    // front after this one in postorder, prefetched in the forward
+    // solve. The factors of this front can be prefetched by another
+    // thread, and are released by the I/O thread after they are
+    // written in the factorization. ooc_mtx_ protects factor_mem_,
+    // ooc_fetch_ and ooc_fwd_done_.
+    const F_t* ooc_next_ = nullptr;
+    mutable std::mutex ooc_mtx_;
+    mutable bool ooc_fwd_done_ = false;
     std::vector<int> piv; // regular int because it is passed to BLAS
+    int etree_level_ = 0; // level in the etree, for the FrontTrace
+
+    // assembly maps, kept for refactorization with the same sparsity
+    // pattern, see SPOptions::enable_assembly_maps
+    bool use_maps_ = false;
+    typename SpMat_t::FrontMap_t Amap_;
+    integer_t Amap_nnz_ = -1;
+    std::vector<std::size_t> upd2pa_;
+    std::size_t upd2sep_ = 0;
+    // result of batchable(batch_max_dsep_), cached
+    mutable int batch_max_dsep_ = 0;
+    mutable bool batchable_ = false;
 
     FrontalMatrixDense(const FrontalMatrixDense&) = delete;
     FrontalMatrixDense& operator=(FrontalMatrixDense const&) = delete;
 
+    void allocate_front(bool with_F12=true);
+    std::size_t factor_size() const;
+    void set_factor_pointers() const;
+    void release_factor_memory();
+    void store_factors();
+    void load_factors() const;
+    void unload_factors(bool forward_done=false) const;
+
+    void assemble_from_sparse
+    (const SpMat_t& A, const SPOptions<scalar_t>& opts, int task_depth);
+    const std::vector<std::size_t>&
+    upd_to_parent_map(const F_t* p, std::size_t& upd2sep);
+
     void factor_phase1
     (const SpMat_t& A, const SPOptions<scalar_t>& opts,
      int etree_level, int task_depth);
@@ -121,6 +180,13 @@ namespace strumpack {
     (const SpMat_t& A, const SPOptions<scalar_t>& opts,
      int etree_level, int task_depth);
 
+    bool batchable(int max_dsep) const;
+    void factor_batched
+    (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+     int etree_level, int task_depth);
+    void factor_small
+    (const SpMat_t& A, const SPOptions<scalar_t>& opts, int etree_level);
+
     virtual void fwd_solve_phase2
     (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const;
     virtual void bwd_solve_phase1
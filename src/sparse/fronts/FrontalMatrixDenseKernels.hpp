@@ -0,0 +1,285 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_DENSE_KERNELS_HPP
+#define FRONTAL_MATRIX_DENSE_KERNELS_HPP
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+#include <memory>
+
+#include "StrumpackConfig.hpp"
+#include "dense/BLASLAPACKWrapper.hpp"
+
+namespace strumpack {
+
+  namespace cpu {
+
+    /**
+     * Partial factorization of a small dense front, with a separator
+     * of size n <= NB and update size m:
+     *
+     *   F11 = P L U, F12 = L^{-1} P^T F12, F21 = F21 U^{-1},
+     *   F22 = F22 - F21 F12.
+     *
+     * F11 is copied to a local NB x NB array so that the LU
+     * factorization works on a block with a compile time leading
+     * dimension, which stays in L1 cache. The pivot vector is
+     * 1-based, as returned by LAPACK getrf, and the return value is
+     * the LAPACK info. If info is nonzero, or if replace is true,
+     * diagonal elements of U smaller than thresh are replaced by
+     * +/- thresh before F12, F21 and F22 are updated.
+     */
+    template<int NB, typename T, typename real_t> int
+    factor_small_front(int n, int m, T* F11, int ld11, T* F12, int ld12,
+                       T* F21, int ld21, T* F22, int ld22, int* piv,
+                       bool replace, real_t thresh) {
+      T A[NB*NB];
+      for (int j=0; j<n; j++)
+        for (int i=0; i<n; i++)
+          A[i+j*NB] = F11[i+j*ld11];
+      int info = 0;
+      for (int k=0; k<n; k++) {
+        int p = k;
+        real_t pmax = std::abs(A[k+k*NB]);
+        for (int i=k+1; i<n; i++) {
+          auto Aik = std::abs(A[i+k*NB]);
+          if (Aik > pmax) { pmax = Aik; p = i; }
+        }
+        piv[k] = p + 1;
+        if (A[p+k*NB] == T(0.)) {
+          if (!info) info = k + 1;
+          continue;
+        }
+        if (p != k)
+          for (int j=0; j<n; j++)
+            std::swap(A[k+j*NB], A[p+j*NB]);
+        const T iAkk = T(1.) / A[k+k*NB];
+        for (int i=k+1; i<n; i++)
+          A[i+k*NB] *= iAkk;
+        for (int j=k+1; j<n; j++) {
+          const T Akj = A[k+j*NB];
+#pragma omp simd
+          for (int i=k+1; i<n; i++)
+            A[i+j*NB] -= A[i+k*NB] * Akj;
+        }
+      }
+      if (info || replace)
+        for (int i=0; i<n; i++)
+          if (std::abs(A[i+i*NB]) < thresh)
+            A[i+i*NB] = (std::real(A[i+i*NB]) < 0) ? -thresh : thresh;
+      for (int j=0; j<n; j++)
+        for (int i=0; i<n; i++)
+          F11[i+j*ld11] = A[i+j*NB];
+      if (!m) return info;
+      // F12 = L^{-1} P^T F12, one column at a time
+      for (int j=0; j<m; j++) {
+        T* b = F12 + j*ld12;
+        for (int k=0; k<n; k++)
+          if (piv[k]-1 != k) std::swap(b[k], b[piv[k]-1]);
+        for (int k=0; k<n; k++) {
+          const T bk = b[k];
+#pragma omp simd
+          for (int i=k+1; i<n; i++)
+            b[i] -= A[i+k*NB] * bk;
+        }
+      }
+      // F21 = F21 U^{-1}, column oriented so the inner loop runs
+      // over the (long) columns of F21
+      for (int k=0; k<n; k++) {
+        T* xk = F21 + k*ld21;
+        for (int i=0; i<k; i++) {
+          const T Uik = A[i+k*NB];
+          const T* xi = F21 + i*ld21;
+#pragma omp simd
+          for (int r=0; r<m; r++)
+            xk[r] -= xi[r] * Uik;
+        }
+        const T iUkk = T(1.) / A[k+k*NB];
+#pragma omp simd
+        for (int r=0; r<m; r++)
+          xk[r] *= iUkk;
+      }
+      // F22 = F22 - F21 F12
+      for (int j=0; j<m; j++) {
+        T* cj = F22 + j*ld22;
+        const T* bj = F12 + j*ld12;
+        for (int k=0; k<n; k++) {
+          const T bkj = bj[k];
+          const T* ak = F21 + k*ld21;
+#pragma omp simd
+          for (int r=0; r<m; r++)
+            cj[r] -= ak[r] * bkj;
+        }
+      }
+      return info;
+    }
+
+    /**
+     * Partial factorization of a large dense front, with separator
+     * size n and update size m, same as factor_small_front, but
+     * using tiles of size nb and OpenMP tasks with dependencies. The
+     * columns of the front, [F11; F21] and [F12; F22], are split in
+     * tiles of nb columns, F21 and F22 are also split in row tiles
+     * of nb rows. For every column panel k of F11:
+     *
+     *  - the panel F11(k:n,k) is factored with getrf (the row
+     *    interchanges are only applied to the panel, and to the
+     *    columns right of it as part of their update),
+     *  - every row tile of F21(:,k) is solved with U(k,k),
+     *  - every column tile j>k of [F11 F12] is permuted, solved with
+     *    L(k,k) and updated with L(k+1:n,k) U(k,j),
+     *  - every tile (i,j) of [F21 F22] is updated with L21(i,k)
+     *    U(k,j).
+     *
+     * Since these only depend on panel k and on the tiles they
+     * update, the factorization of panel k+1 can start as soon as
+     * column tile k+1 has been updated, while the Schur complement
+     * update for panel k continues (lookahead, the panel and the
+     * next column get a higher priority). The interchanges for the
+     * columns left of each panel are applied at the end. If a zero
+     * pivot is found in a panel, or if replace is true, diagonal
+     * elements of U in that panel smaller than thresh are replaced by
+     * +/- thresh, before they are used in the updates. Each panel
+     * keeps its own getrf info, the first nonzero one is returned,
+     * relative to the whole front. This should be
+     * called from within an OpenMP parallel region (or the tasks
+     * are executed by the calling thread).
+     *
+     * Without support for OpenMP task dependencies, this executes the
+     * same tile operations in sequence.
+     */
+    template<typename T, typename real_t> int
+    factor_tiled_front(int n, int m, T* F11, int ld11, T* F12, int ld12,
+                       T* F21, int ld21, T* F22, int ld22, int* piv,
+                       bool replace, real_t thresh, int nb) {
+      const int nt1 = (n + nb - 1) / nb, nt2 = (m + nb - 1) / nb,
+        nt = nt1 + nt2, mt = nt2;
+      // info per panel, to avoid sharing a single info between tasks
+      std::unique_ptr<int[]> pinfo(new int[nt1]());
+      // top part (first n rows) and bottom part (last m rows) of
+      // column tile j
+      auto top = [&](int j, int& ld) {
+        if (j < nt1) { ld = ld11; return F11 + std::size_t(j)*nb*ld11; }
+        ld = ld12; return F12 + std::size_t(j-nt1)*nb*ld12;
+      };
+      auto bot = [&](int j, int& ld) {
+        if (j < nt1) { ld = ld21; return F21 + std::size_t(j)*nb*ld21; }
+        ld = ld22; return F22 + std::size_t(j-nt1)*nb*ld22;
+      };
+      auto width = [&](int j) {
+        return (j < nt1) ? std::min(nb, n-j*nb) : std::min(nb, m-(j-nt1)*nb);
+      };
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+      // dummies for task synchronization, D for the column tiles of
+      // [F11 F12], E for the tiles of [F21 F22]
+      std::unique_ptr<int[]> D_(new int[nt + std::size_t(mt)*nt]);
+      auto D = D_.get();
+      auto E = D + nt;
+#pragma omp taskgroup
+#endif
+      {
+        for (int k=0; k<nt1; k++) {
+          const int kb = k*nb, w = width(k);
+          T* Lkk = F11 + kb + std::size_t(kb)*ld11;
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(k,kb,w,Lkk)       \
+  depend(inout:D[k]) priority(nt)
+#endif
+          {
+            blas::getrf(n-kb, w, Lkk, ld11, piv+kb, &pinfo[k]);
+            for (int i=0; i<w; i++) piv[kb+i] += kb;
+            if (pinfo[k] || replace)
+              for (int i=0; i<w; i++)
+                if (std::abs(Lkk[i+i*ld11]) < thresh)
+                  Lkk[i+i*ld11] =
+                    (std::real(Lkk[i+i*ld11]) < 0) ? -thresh : thresh;
+          }
+          for (int i=0; i<mt; i++) {
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(i,k,kb,w,Lkk)     \
+  depend(in:D[k]) depend(inout:E[i+mt*k]) priority(nt-k)
+#endif
+            blas::trsm
+              ('R', 'U', 'N', 'N', std::min(nb, m-i*nb), w, T(1.),
+               Lkk, ld11, F21 + i*nb + std::size_t(kb)*ld21, ld21);
+          }
+          for (int j=k+1; j<nt; j++) {
+            const int wj = width(j);
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(j,k,kb,w,wj,Lkk)  \
+  depend(in:D[k]) depend(inout:D[j]) priority(j==k+1 ? nt : nt-j)
+#endif
+            {
+              int ldt;
+              T* Tj = top(j, ldt);
+              blas::laswp(wj, Tj, ldt, kb+1, kb+w, piv, 1);
+              blas::trsm
+                ('L', 'L', 'N', 'U', w, wj, T(1.), Lkk, ld11, Tj+kb, ldt);
+              if (n-kb-w > 0)
+                blas::gemm
+                  ('N', 'N', n-kb-w, wj, w, T(-1.), Lkk+w, ld11,
+                   Tj+kb, ldt, T(1.), Tj+kb+w, ldt);
+            }
+            for (int i=0; i<mt; i++) {
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(i,j,k,kb,w,wj)    \
+  depend(in:E[i+mt*k],D[j]) depend(inout:E[i+mt*j])             \
+  priority(j==k+1 ? nt : nt-j)
+#endif
+              {
+                int ldt, ldb;
+                T* Tj = top(j, ldt);
+                T* Bj = bot(j, ldb);
+                blas::gemm
+                  ('N', 'N', std::min(nb, m-i*nb), wj, w, T(-1.),
+                   F21 + i*nb + std::size_t(kb)*ld21, ld21, Tj+kb, ldt,
+                   T(1.), Bj + i*nb, ldb);
+              }
+            }
+          }
+        }
+      }
+      // apply the row interchanges of the later panels to the
+      // columns left of those panels
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+      for (int j=0; j<nt1-1; j++)
+        blas::laswp(width(j), F11 + std::size_t(j)*nb*ld11, ld11,
+                    (j+1)*nb+1, n, piv, 1);
+      for (int k=0; k<nt1; k++)
+        if (pinfo[k]) return k*nb + pinfo[k];
+      return 0;
+    }
+
+  } // end namespace cpu
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_DENSE_KERNELS_HPP
@@ -27,6 +27,7 @@
  *
  */
 #include <fstream>
+#include <numeric>
 
 #include "FrontalMatrixDenseMPI.hpp"
 #include "FrontalMatrixBLRMPI.hpp"
@@ -81,10 +82,19 @@ namespace strumpack {
       return FMPI_t::node_factor_nonzeros();
   }
 
+  /**
+   * Copy the contribution blocks of the children to the send buffers
+   * and start sending them to the ranks of this front. Only
+   * non-empty buffers are sent, typically a child rank only sends to
+   * a few of the parent ranks. The sends (and sbuf) should be
+   * completed with wait_all(sreq) after extend_add_recv.
+   */
   template<typename scalar_t,typename integer_t> void
-  FrontalMatrixDenseMPI<scalar_t,integer_t>::extend_add() {
+  FrontalMatrixDenseMPI<scalar_t,integer_t>::extend_add_send
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   std::vector<MPI_Request>& sreq) const {
     if (!lchild_ && !rchild_) return;
-    std::vector<std::vector<scalar_t>> sbuf(this->P());
+    sbuf.resize(this->P());
     for (auto& ch : {lchild_.get(), rchild_.get()}) {
       if (ch && Comm().is_root()) {
         STRUMPACK_FLOPS
@@ -93,19 +103,70 @@ namespace strumpack {
       if (!visit(ch)) continue;
       ch->extend_add_copy_to_buffers(sbuf, this);
     }
-    std::vector<scalar_t,NoInit<scalar_t>> rbuf;
-    std::vector<scalar_t*> pbuf;
-    Comm().all_to_all_v(sbuf, rbuf, pbuf);
-    for (auto& ch : {lchild_.get(), rchild_.get()}) {
-      if (!ch) continue;
-      ch->extend_add_copy_from_buffers
-        (F11_, F12_, F21_, F22_, pbuf.data()+this->master(ch), this);
+    sreq.reserve(sbuf.size());
+    for (std::size_t p=0; p<sbuf.size(); p++)
+      if (!sbuf[p].empty()) {
+        sreq.emplace_back();
+        Comm().isend(sbuf[p], p, 0, &sreq.back());
+      }
+  }
+
+  /**
+   * Receive the contribution blocks of the children and add them to
+   * this front. The number of elements to receive from each rank is
+   * computed locally from the index sets, so there is no size
+   * exchange (unlike with all_to_all_v). The contributions of the
+   * left child are added as soon as they have arrived, while the
+   * ranks of the right child might still be working.
+   */
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseMPI<scalar_t,integer_t>::extend_add_recv() {
+    if (!lchild_ && !rchild_) return;
+    using ExtAdd = ExtendAdd<scalar_t,integer_t>;
+    const std::size_t P = this->P();
+    std::vector<std::size_t> cl(P), cr(P);
+    if (lchild_)
+      ExtAdd::extend_add_recv_counts
+        (F11_, F22_, this, lchild_.get(), this->master(lchild_), cl);
+    if (rchild_)
+      ExtAdd::extend_add_recv_counts
+        (F11_, F22_, this, rchild_.get(), this->master(rchild_), cr);
+    std::vector<scalar_t,NoInit<scalar_t>> rbuf
+      (std::accumulate(cl.begin(), cl.end(), std::size_t(0)) +
+       std::accumulate(cr.begin(), cr.end(), std::size_t(0)));
+    std::vector<scalar_t*> pbuf(P);
+    std::vector<MPI_Request> rreql, rreqr;
+    rreql.reserve(P);
+    rreqr.reserve(P);
+    for (std::size_t p=0, displ=0; p<P; p++) {
+      pbuf[p] = rbuf.data() + displ;
+      auto n = cl[p] + cr[p];
+      if (!n) continue;
+      // a rank that holds part of both children sends a single
+      // message, with the left child's part first
+      auto& reqs = cl[p] ? rreql : rreqr;
+      reqs.emplace_back();
+      Comm().irecv(pbuf[p], n, p, 0, &reqs.back());
+      displ += n;
     }
+    wait_all(rreql);
+    if (lchild_)
+      lchild_->extend_add_copy_from_buffers
+        (F11_, F12_, F21_, F22_, pbuf.data()+this->master(lchild_), this);
+    wait_all(rreqr);
+    if (rchild_)
+      rchild_->extend_add_copy_from_buffers
+        (F11_, F12_, F21_, F22_, pbuf.data()+this->master(rchild_), this);
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDenseMPI<scalar_t,integer_t>::build_front
   (const SpMat_t& A) {
+    // start sending the contribution blocks before assembling the
+    // sparse entries, to overlap communication and assembly
+    std::vector<std::vector<scalar_t>> sbuf;
+    std::vector<MPI_Request> sreq;
+    extend_add_send(sbuf, sreq);
     const auto dupd = this->dim_upd();
     const auto dsep = this->dim_sep();
     if (dsep) {
@@ -125,12 +186,18 @@ namespace strumpack {
       F22_ = DistM_t(grid(), dupd, dupd);
       F22_.zero();
     }
-    extend_add();
+    extend_add_recv();
+    wait_all(sreq);
   }
 
-  template<typename scalar_t,typename integer_t> void
+  /**
+   * Factor F11 and compute the Schur complement in F22. Returns the
+   * number of flops, counted on the master process of the grid only.
+   */
+  template<typename scalar_t,typename integer_t> long long
   FrontalMatrixDenseMPI<scalar_t,integer_t>::partial_factorization
   (const SPOptions<scalar_t>& opts) {
+    long long flops = 0;
     if (this->dim_sep() && grid()->active()) {
       TaskTimer pf("FrontalMatrixDenseMPI_factor");
       pf.start();
@@ -157,7 +224,7 @@ namespace strumpack {
             Fii = (std::real(Fii) < 0) ? -thresh : thresh;
         }
       }
-      long long flops = LU_flops(F11_);
+      flops = LU_flops(F11_);
       if (this->dim_upd()) {
 #if defined(STRUMPACK_USE_SLATE_SCALAPACK)
         auto slateF12 = slate_matrix(F12_);
@@ -196,6 +263,7 @@ namespace strumpack {
       STRUMPACK_FLOPS(flops);
 #endif
     }
+    return flops;
   }
 
 #if defined(STRUMPACK_USE_SLATE_SCALAPACK)
@@ -217,7 +285,18 @@ namespace strumpack {
       rchild_->multifrontal_factorization(A, opts, etree_level+1, task_depth);
     TaskTimer t("FrontalMatrixDenseMPI_factor");
     if (etree_level == 0 && opts.print_root_front_stats()) t.start();
-    build_front(A);
+    // local size of the front, in bytes
+    auto front_bytes = [&]() -> long long {
+      long long n = 0;
+      for (auto F : {&F11_, &F12_, &F21_, &F22_})
+        n += (long long)(F->lrows()) * F->lcols();
+      return n * sizeof(scalar_t);
+    };
+    {
+      FrontTraceScope trace(FrontPhase::ASSEMBLY, this, etree_level);
+      build_front(A);
+      trace.add_bytes(front_bytes());
+    }
     if (etree_level == 0 && opts.write_root_front()) {
       //F11_.print_to_files("Froot");
       auto Fs = F11_.gather();
@@ -233,7 +312,11 @@ namespace strumpack {
     }
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
-    partial_factorization(opts);
+    {
+      FrontTraceScope trace
+        (FrontPhase::FACTOR, this, etree_level, 0, front_bytes());
+      trace.add_flops(partial_factorization(opts));
+    }
 #if defined(STRUMPACK_USE_ZFP)
     compress(opts);
 #endif
@@ -249,8 +332,11 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDenseMPI<scalar_t,integer_t>::compress
   (const SPOptions<scalar_t>& opts) {
-    if (opts.compression() == CompressionType::LOSSY) {
-      auto prec = opts.lossy_precision();
+    if (opts.compression() == CompressionType::LOSSY ||
+        opts.compression() == CompressionType::LOSSLESS) {
+      // precision <= 0 selects reversible (lossless) mode
+      auto prec = opts.compression() == CompressionType::LOSSY ?
+        opts.lossy_precision() : 0;
       F11c_ = LossyMatrix<scalar_t>(F11_.dense_wrapper(), prec);
       F12c_ = LossyMatrix<scalar_t>(F12_.dense_wrapper(), prec);
       F21c_ = LossyMatrix<scalar_t>(F21_.dense_wrapper(), prec);
@@ -67,7 +67,6 @@ namespace strumpack {
 
     void release_work_memory() override;
 
-    void extend_add();
     void extend_add_copy_to_buffers
     (std::vector<std::vector<scalar_t>>& sbuf, const FMPI_t* pa) const override;
     void extadd_blr_copy_to_buffers
@@ -106,7 +105,11 @@ namespace strumpack {
     std::vector<int> piv;
 
     void build_front(const SpMat_t& A);
-    void partial_factorization(const SPOptions<scalar_t>& opts);
+    void extend_add_send
+    (std::vector<std::vector<scalar_t>>& sbuf,
+     std::vector<MPI_Request>& sreq) const;
+    void extend_add_recv();
+    long long partial_factorization(const SPOptions<scalar_t>& opts);
 
     void fwd_solve_phase2
     (const DistM_t& F11, const DistM_t& F12, const DistM_t& F21,
@@ -0,0 +1,318 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+
+#include "FrontalMatrixDenseSym.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "ExtendAdd.hpp"
+#include "FrontalMatrixMPI.hpp"
+#include "FrontalMatrixBLRMPI.hpp"
+#endif
+
+namespace strumpack {
+
+  /**
+   * Compute the lower triangular part of C = C - A * op(B), with C
+   * square, in blocks of columns. Returns the number of flops.
+   */
+  template<typename scalar_t> long long
+  lower_gemm_update(Trans op, const DenseMatrix<scalar_t>& A,
+                    const DenseMatrix<scalar_t>& B,
+                    DenseMatrix<scalar_t>& C, int depth) {
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    const std::size_t n = C.rows(), k = A.cols(), nb = 64;
+    long long flops = 0;
+    for (std::size_t j=0; j<n; j+=nb) {
+      auto jb = std::min(nb, n-j);
+      DenseMW_t Cj(n-j, jb, C, j, j);
+      const DenseMW_t Aj(n-j, k, const_cast<DenseMatrix<scalar_t>&>(A), j, 0);
+      const DenseMW_t Bj = (op == Trans::N) ?
+        DenseMW_t(k, jb, const_cast<DenseMatrix<scalar_t>&>(B), 0, j) :
+        DenseMW_t(jb, k, const_cast<DenseMatrix<scalar_t>&>(B), j, 0);
+      gemm(Trans::N, op, scalar_t(-1.), Aj, Bj, scalar_t(1.), Cj, depth);
+      flops += gemm_flops
+        (Trans::N, op, scalar_t(-1.), Aj, Bj, scalar_t(1.));
+    }
+    return flops;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  FrontalMatrixDenseSym<scalar_t,integer_t>::FrontalMatrixDenseSym
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd, FactorizationType ft)
+    : FD_t(sep, sep_begin, sep_end, upd), ft_(ft) {}
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::extend_add_to_dense
+  (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
+   const F_t* p, int task_depth) {
+    const std::size_t pdsep = paF11.rows();
+    const std::size_t dupd = dim_upd();
+    FrontTraceScope trace
+      (FrontPhase::EXTEND_ADD, this, this->etree_level_,
+       (is_complex<scalar_t>()?2:1) * dupd * (dupd+1) / 2,
+       dupd * (dupd+1) / 2 * sizeof(scalar_t));
+    std::size_t upd2sep;
+    const auto& I = this->upd_to_parent_map(p, upd2sep);
+    // I is increasing, so the lower triangular part of the CB maps to
+    // the lower triangular part of the parent, F12 is never touched
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(64)      \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t c=0; c<dupd; c++) {
+      auto pc = I[c];
+      if (pc < pdsep) {
+        for (std::size_t r=c; r<upd2sep; r++)
+          paF11(I[r],pc) += F22_(r,c);
+        for (std::size_t r=std::max(c, upd2sep); r<dupd; r++)
+          paF21(I[r]-pdsep,pc) += F22_(r,c);
+      } else {
+        for (std::size_t r=c; r<dupd; r++)
+          paF22(I[r]-pdsep,pc-pdsep) += F22_(r,c);
+      }
+    }
+    STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * (dupd+1) / 2);
+    STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * (dupd+1) / 2);
+    this->release_work_memory();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::multifrontal_factorization
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+   int etree_level, int task_depth) {
+    if (task_depth == 0) {
+      // use tasking for children and for extend-add parallelism
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+      factor_phase1(A, opts, etree_level, task_depth);
+      // do not use tasking for blas/lapack parallelism (use system
+      // blas threading!)
+      factor_phase2(A, opts, etree_level, params::task_recursion_cutoff_level);
+    } else {
+      factor_phase1(A, opts, etree_level, task_depth);
+      factor_phase2(A, opts, etree_level, task_depth);
+    }
+    this->store_factors();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::factor_phase1
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+   int etree_level, int task_depth) {
+    if (task_depth < params::task_recursion_cutoff_level) {
+      const int dl = this->child_task_depth(lchild_.get(), task_depth),
+        dr = this->child_task_depth(rchild_.get(), task_depth);
+      if (lchild_)
+#pragma omp task default(shared)                                        \
+  final(dl >= params::task_recursion_cutoff_level) mergeable
+        lchild_->multifrontal_factorization(A, opts, etree_level+1, dl);
+      if (rchild_)
+#pragma omp task default(shared)                                        \
+  final(dr >= params::task_recursion_cutoff_level) mergeable
+        rchild_->multifrontal_factorization(A, opts, etree_level+1, dr);
+#pragma omp taskwait
+    } else {
+      if (lchild_)
+        lchild_->multifrontal_factorization
+          (A, opts, etree_level+1, task_depth);
+      if (rchild_)
+        rchild_->multifrontal_factorization
+          (A, opts, etree_level+1, task_depth);
+    }
+    this->etree_level_ = etree_level;
+    {
+      const std::size_t dsep = dim_sep(), dupd = dim_upd();
+      FrontTraceScope trace
+        (FrontPhase::ASSEMBLY, this, etree_level, 0,
+         (dsep * (dsep + dupd) + dupd * dupd) * sizeof(scalar_t));
+      // F12_ is left empty, extract_front will skip it
+      this->allocate_front(false);
+      this->assemble_from_sparse(A, opts, task_depth);
+      if (lchild_)
+        lchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
+      if (rchild_)
+        rchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
+    }
+    if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::factor_phase2
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+   int etree_level, int task_depth) {
+    info_ = 0;
+    if (!dim_sep()) return;
+    const std::size_t dsep = dim_sep(), dupd = dim_upd();
+    FrontTraceScope trace
+      (FrontPhase::FACTOR, this, etree_level, 0,
+       (dsep * (dsep + dupd) + dupd * dupd) * sizeof(scalar_t));
+    long long flops = 0;
+    if (ft_ == FactorizationType::CHOLESKY) {
+      // a non-positive pivot cannot be replaced, potrf stops there,
+      // the failure is reported by factor_failed
+      info_ = F11_.Cholesky(task_depth);
+      if (info_) return;
+      flops += (is_complex<scalar_t>() ? 4:1) * blas::potrf_flops(dsep);
+      if (dupd) {
+        // L21 = F21 L11^-H, F22 = F22 - L21 L21^H
+        trsm(Side::R, UpLo::L, Trans::C, Diag::N,
+             scalar_t(1.), F11_, F21_, task_depth);
+        flops += trsm_flops(Side::R, scalar_t(1.), F11_, F21_) +
+          lower_gemm_update(Trans::C, F21_, F21_, F22_, task_depth);
+      }
+    } else {
+      piv = F11_.LDLt(task_depth);
+      // sytrf only fails on an exactly zero 1x1 diagonal block, then
+      // replace tiny pivots as in the LU factorization
+      bool zero = false;
+      for (std::size_t i=0; i<dsep; i++)
+        if (piv[i] > 0 && F11_(i,i) == scalar_t(0.)) zero = true;
+      if (zero || opts.replace_tiny_pivots()) {
+        // only 1x1 diagonal blocks, 2x2 blocks are not singular
+        auto thresh = opts.pivot_threshold();
+        for (std::size_t i=0; i<dsep; i++)
+          if (piv[i] > 0 && std::abs(F11_(i,i)) < thresh)
+            F11_(i,i) = (std::real(F11_(i,i)) < 0) ? -thresh : thresh;
+      }
+      flops += (is_complex<scalar_t>() ? 4:1) * blas::sytrf_flops(dsep);
+      if (dupd) {
+        // X = F11^-1 F21^T, F22 = F22 - F21 X, F21 is kept as is
+        DenseM_t X(dsep, dupd);
+        for (std::size_t j=0; j<dupd; j++)
+          for (std::size_t i=0; i<dsep; i++)
+            X(i,j) = F21_(j,i);
+        F11_.solve_LDLt_in_place(X, piv, task_depth);
+        flops += (is_complex<scalar_t>() ? 4:1) *
+          blas::sytrs_flops(dsep, dsep, dupd) +
+          lower_gemm_update(Trans::N, F21_, X, F22_, task_depth);
+      }
+    }
+    trace.add_flops(flops);
+    STRUMPACK_FULL_RANK_FLOPS(flops);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    if (!dim_sep()) return;
+    DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+    if (ft_ == FactorizationType::CHOLESKY) {
+      if (b.cols() == 1)
+        trsv(UpLo::L, Trans::N, Diag::N, F11_, bloc, task_depth);
+      else
+        trsm(Side::L, UpLo::L, Trans::N, Diag::N,
+             scalar_t(1.), F11_, bloc, task_depth);
+    } else F11_.solve_LDLt_in_place(bloc, piv, task_depth);
+    if (dim_upd()) {
+      if (b.cols() == 1)
+        gemv(Trans::N, scalar_t(-1.), F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
+      else
+        gemm(Trans::N, Trans::N, scalar_t(-1.), F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    if (!dim_sep()) return;
+    DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+    if (ft_ == FactorizationType::CHOLESKY) {
+      if (y.cols() == 1) {
+        if (dim_upd())
+          gemv(Trans::C, scalar_t(-1.), F21_, yupd,
+               scalar_t(1.), yloc, task_depth);
+        trsv(UpLo::L, Trans::C, Diag::N, F11_, yloc, task_depth);
+      } else {
+        if (dim_upd())
+          gemm(Trans::C, Trans::N, scalar_t(-1.), F21_, yupd,
+               scalar_t(1.), yloc, task_depth);
+        trsm(Side::L, UpLo::L, Trans::C, Diag::N,
+             scalar_t(1.), F11_, yloc, task_depth);
+      }
+    } else if (dim_upd()) {
+      // yloc already holds F11^-1 bloc, subtract F11^-1 F21^T yupd
+      DenseM_t t(dim_sep(), y.cols());
+      gemm(Trans::T, Trans::N, scalar_t(1.), F21_, yupd,
+           scalar_t(0.), t, task_depth);
+      F11_.solve_LDLt_in_place(t, piv, task_depth);
+      yloc.sub(t, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> DenseMatrix<scalar_t>
+  FrontalMatrixDenseSym<scalar_t,integer_t>::full_CB() const {
+    // the distributed fronts expect the full CB, mirror the lower part
+    DenseM_t CB(F22_);
+    const std::size_t dupd = CB.rows();
+    bool herm = ft_ == FactorizationType::CHOLESKY;
+    for (std::size_t c=0; c<dupd; c++)
+      for (std::size_t r=c+1; r<dupd; r++)
+        CB(c,r) = herm ? blas::my_conj(CB(r,c)) : CB(r,c);
+    return CB;
+  }
+
+#if defined(STRUMPACK_USE_MPI)
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::extend_add_copy_to_buffers
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   const FrontalMatrixMPI<scalar_t,integer_t>* pa) const {
+    ExtendAdd<scalar_t,integer_t>::extend_add_seq_copy_to_buffers
+      (full_CB(), sbuf, pa, this);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDenseSym<scalar_t,integer_t>::extadd_blr_copy_to_buffers
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   const FrontalMatrixBLRMPI<scalar_t,integer_t>* pa) const {
+    BLR::BLRExtendAdd<scalar_t,integer_t>::
+      seq_copy_to_buffers(full_CB(), sbuf, pa, this);
+  }
+#endif
+
+  // explicit template instantiations
+  template class FrontalMatrixDenseSym<float,int>;
+  template class FrontalMatrixDenseSym<double,int>;
+  template class FrontalMatrixDenseSym<std::complex<float>,int>;
+  template class FrontalMatrixDenseSym<std::complex<double>,int>;
+
+  template class FrontalMatrixDenseSym<float,long int>;
+  template class FrontalMatrixDenseSym<double,long int>;
+  template class FrontalMatrixDenseSym<std::complex<float>,long int>;
+  template class FrontalMatrixDenseSym<std::complex<double>,long int>;
+
+  template class FrontalMatrixDenseSym<float,long long int>;
+  template class FrontalMatrixDenseSym<double,long long int>;
+  template class FrontalMatrixDenseSym<std::complex<float>,long long int>;
+  template class FrontalMatrixDenseSym<std::complex<double>,long long int>;
+
+} // end namespace strumpack
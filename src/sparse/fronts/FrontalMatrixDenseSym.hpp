@@ -0,0 +1,129 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_DENSE_SYM_HPP
+#define FRONTAL_MATRIX_DENSE_SYM_HPP
+
+#include "FrontalMatrixDense.hpp"
+
+namespace strumpack {
+
+  /**
+   * Dense frontal matrix for a symmetric multifrontal
+   * factorization. The separator block F11 is factored using either
+   * Cholesky, F11 = L11 L11^H, or LDL^T with Bunch-Kaufman pivoting,
+   * F11 = P L11 D L11^T P^T. Only the lower triangular part of the
+   * front is assembled and factored, F12 is never stored, and only
+   * the lower triangular part of the contribution block F22 is
+   * computed and passed to the parent.
+   *
+   * For Cholesky, F21 is overwritten with L21 = F21 L11^-H. For LDLt,
+   * the (unfactored) F21 is kept and the solve is done with a call
+   * to sytrs on F11 instead.
+   */
+  template<typename scalar_t,typename integer_t> class FrontalMatrixDenseSym
+    : public FrontalMatrixDense<scalar_t,integer_t> {
+    using F_t = FrontalMatrix<scalar_t,integer_t>;
+    using FD_t = FrontalMatrixDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+
+  public:
+    FrontalMatrixDenseSym
+    (integer_t sep, integer_t sep_begin, integer_t sep_end,
+     std::vector<integer_t>& upd, FactorizationType ft);
+
+    void extend_add_to_dense
+    (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
+     const F_t* p, int task_depth) override;
+
+    void multifrontal_factorization
+    (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+     int etree_level=0, int task_depth=0) override;
+
+    std::string type() const override { return "FrontalMatrixDenseSym"; }
+
+    bool factor_failed() const override {
+      return info_ || F_t::factor_failed();
+    }
+
+#if defined(STRUMPACK_USE_MPI)
+    void extend_add_copy_to_buffers
+    (std::vector<std::vector<scalar_t>>& sbuf,
+     const FrontalMatrixMPI<scalar_t,integer_t>* pa) const override;
+    void extadd_blr_copy_to_buffers
+    (std::vector<std::vector<scalar_t>>& sbuf,
+     const FrontalMatrixBLRMPI<scalar_t,integer_t>* pa) const override;
+#endif
+
+  private:
+    FactorizationType ft_;
+    // info from potrf in the last factorization, a zero pivot in
+    // LDLt is replaced (see factor_phase2)
+    int info_ = 0;
+
+    FrontalMatrixDenseSym(const FrontalMatrixDenseSym&) = delete;
+    FrontalMatrixDenseSym& operator=(FrontalMatrixDenseSym const&) = delete;
+
+    void factor_phase1
+    (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+     int etree_level, int task_depth);
+    void factor_phase2
+    (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+     int etree_level, int task_depth);
+
+    void fwd_solve_phase2
+    (DenseM_t& b, DenseM_t& bupd, int etree_level,
+     int task_depth) const override;
+    void bwd_solve_phase1
+    (DenseM_t& y, DenseM_t& yupd, int etree_level,
+     int task_depth) const override;
+
+    DenseM_t full_CB() const;
+
+    long long dense_node_factor_nonzeros() const override {
+      long long dsep = dim_sep();
+      long long dupd = dim_upd();
+      return dsep * (dsep + dupd);
+    }
+
+    using FD_t::F11_;
+    using FD_t::F12_;
+    using FD_t::F21_;
+    using FD_t::F22_;
+    using FD_t::piv;
+    using F_t::lchild_;
+    using F_t::rchild_;
+    using F_t::dim_sep;
+    using F_t::dim_upd;
+  };
+
+} // end namespace strumpack
+
+#endif // FRONTAL_MATRIX_DENSE_SYM_HPP
@@ -254,29 +254,23 @@ namespace strumpack {
       auto dd = opts.HSS_options().dd();
       auto d0 = opts.HSS_options().d0();
       integer_t d = Rr.cols(), m = Rr.rows();
-      if (d0 % dd == 0) {
-        for (integer_t c=0; c<d; c+=dd) {
-          integer_t r = 0, cs = c + _sampled_columns;
-          for (; r<dsep; r++) {
-            rgen->seed(std::uint32_t(r+sep_begin_), std::uint32_t(cs));
-            for (integer_t cc=c; cc<c+dd; cc++)
-              Rr(r,cc) = Rc(r,cc) = rgen->get();
-          }
-          for (; r<m; r++) {
-            rgen->seed(std::uint32_t(this->upd_[r-dsep]),
-                       std::uint32_t(cs));
-            for (integer_t cc=c; cc<c+dd; cc++)
-              Rr(r,cc) = Rc(r,cc) = rgen->get();
-          }
-        }
-      } else {
-        for (integer_t c=0; c<d; c++) {
-          integer_t r = 0, cs = c + _sampled_columns;
-          for (; r<dsep; r++)
-            Rr(r,c) = Rc(r,c) = rgen->get(r+sep_begin_, cs);
-          for (; r<m; r++)
-            Rr(r,c) = Rc(r,c) = rgen->get(this->upd_[r-dsep], cs);
-        }
+      // element (r,c) only depends on the global row index and the
+      // global column block, so the samples do not depend on the
+      // front structure
+      if (d0 % dd) dd = 1;
+      std::vector<std::uint32_t> gI(m);
+      for (integer_t r=0; r<dsep; r++)
+        gI[r] = std::uint32_t(r+sep_begin_);
+      for (integer_t r=dsep; r<m; r++)
+        gI[r] = std::uint32_t(this->upd_[r-dsep]);
+      std::vector<real_t> R(m*dd);
+      for (integer_t c=0; c<d; c+=dd) {
+        integer_t nc = std::min(integer_t(dd), d-c);
+        rgen->fill(m, nc, gI.data(), std::uint32_t(c + _sampled_columns),
+                   R.data(), m);
+        for (integer_t cc=0; cc<nc; cc++)
+          for (integer_t r=0; r<m; r++)
+            Rr(r,c+cc) = Rc(r,c+cc) = R[r+cc*m];
       }
       STRUMPACK_FLOPS(rgen->flops_per_prng()*d*m);
       STRUMPACK_RANDOM_FLOPS(rgen->flops_per_prng()*d*m);
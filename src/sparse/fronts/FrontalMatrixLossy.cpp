@@ -37,50 +37,69 @@ namespace strumpack {
   template<> inline zfp_type get_zfp_type<double>() { return zfp_type_double; }
 
   template<typename T> LossyMatrix<T>::LossyMatrix
-  (const DenseMatrix<T>& F, uint prec)
-    : rows_(F.rows()), cols_(F.cols()), prec_(prec) {
+  (const DenseMatrix<T>& F, int prec, std::size_t panel)
+    : rows_(F.rows()), cols_(F.cols()), panel_(panel), prec_(prec) {
     if (!rows_ || !cols_) return;
-    zfp_field* f = zfp_field_2d
-      (static_cast<void*>(const_cast<T*>(F.data())),
-       get_zfp_type<T>(), rows_, cols_);
     zfp_stream* stream = zfp_stream_open(NULL);
     if (prec_ <= 0) zfp_stream_set_reversible(stream);
     else zfp_stream_set_precision(stream, prec_);
-    auto bufsize = zfp_stream_maximum_size(stream, f);
-    buffer_.resize(bufsize);
-    bitstream* bstream = stream_open(buffer_.data(), bufsize);
-    zfp_stream_set_bit_stream(stream, bstream);
-    zfp_stream_rewind(stream);
-    auto comp_size = zfp_compress(stream, f);
-    buffer_.resize(comp_size);
-    zfp_stream_flush(stream);
-    zfp_field_free(f);
+    std::vector<unsigned char> pbuf;
+    auto np = (cols_ + panel_ - 1) / panel_;
+    offsets_.resize(np+1);
+    for (std::size_t p=0; p<np; p++) {
+      zfp_field* f = zfp_field_2d
+        (static_cast<void*>(const_cast<T*>(F.ptr(0, panel_begin(p)))),
+         get_zfp_type<T>(), rows_, panel_cols(p));
+      zfp_field_set_stride_2d(f, 1, F.ld());
+      auto bufsize = zfp_stream_maximum_size(stream, f);
+      pbuf.resize(bufsize);
+      bitstream* bstream = stream_open(pbuf.data(), bufsize);
+      zfp_stream_set_bit_stream(stream, bstream);
+      zfp_stream_rewind(stream);
+      auto comp_size = zfp_compress(stream, f);
+      zfp_stream_flush(stream);
+      buffer_.insert(buffer_.end(), pbuf.begin(), pbuf.begin()+comp_size);
+      offsets_[p+1] = buffer_.size();
+      zfp_field_free(f);
+      stream_close(bstream);
+    }
     zfp_stream_close(stream);
-    stream_close(bstream);
+    buffer_.shrink_to_fit();
   }
 
-  template<typename T> void LossyMatrix<T>::decompress
-  (DenseMatrix<T>& F) const {
-    assert(F.rows() == rows_ && F.cols() == cols_);
-    if (!rows_ || !cols_) return;
+  template<typename T> void LossyMatrix<T>::decompress_panel
+  (std::size_t p, DenseMatrix<T>& P) const {
+    assert(P.rows() == rows_ && P.cols() == panel_cols(p));
     zfp_field* f = zfp_field_2d
-      (static_cast<void*>(F.data()), get_zfp_type<T>(), rows_, cols_);
+      (static_cast<void*>(P.data()), get_zfp_type<T>(), rows_, P.cols());
+    zfp_field_set_stride_2d(f, 1, P.ld());
     zfp_stream* destream = zfp_stream_open(NULL);
-    zfp_stream_set_precision(destream, prec_);
+    if (prec_ <= 0) zfp_stream_set_reversible(destream);
+    else zfp_stream_set_precision(destream, prec_);
     bitstream* bstream = stream_open
       (static_cast<void*>
-       (const_cast<uchar*>(buffer_.data())), buffer_.size());
+       (const_cast<uchar*>(buffer_.data() + offsets_[p])),
+       offsets_[p+1] - offsets_[p]);
     zfp_stream_set_bit_stream(destream, bstream);
     zfp_stream_rewind(destream);
     zfp_decompress(destream, f);
     zfp_field_free(f);
     zfp_stream_close(destream);
     stream_close(bstream);
-    return;
+  }
+
+  template<typename T> void LossyMatrix<T>::decompress
+  (DenseMatrix<T>& F) const {
+    assert(F.rows() == rows_ && F.cols() == cols_);
+    if (!rows_ || !cols_) return;
+    for (std::size_t p=0; p<panels(); p++) {
+      DenseMatrixWrapper<T> Fp(rows_, panel_cols(p), F, 0, panel_begin(p));
+      decompress_panel(p, Fp);
+    }
   }
 
   template<typename T> LossyMatrix<std::complex<T>>::LossyMatrix
-  (const DenseMatrix<std::complex<T>>& F, uint prec) {
+  (const DenseMatrix<std::complex<T>>& F, int prec, std::size_t panel) {
     int rows = F.rows(), cols = F.cols();
     DenseMatrix<T> Freal(rows, cols), Fimag(rows, cols);
     for (int j=0; j<cols; j++)
@@ -88,19 +107,29 @@ namespace strumpack {
         Freal(i, j) = F(i,j).real();
         Fimag(i, j) = F(i,j).imag();
       }
-    Freal_ = LossyMatrix<T>(Freal, prec);
-    Fimag_ = LossyMatrix<T>(Fimag, prec);
+    Freal_ = LossyMatrix<T>(Freal, prec, panel);
+    Fimag_ = LossyMatrix<T>(Fimag, prec, panel);
   }
 
-  template<typename T> void LossyMatrix<std::complex<T>>::decompress
-  (DenseMatrix<std::complex<T>>& F) const {
-    auto Freal = Freal_.decompress();
-    auto Fimag = Fimag_.decompress();
-    int rows = Freal_.rows(), cols = Freal_.cols();
+  template<typename T> void LossyMatrix<std::complex<T>>::decompress_panel
+  (std::size_t p, DenseMatrix<std::complex<T>>& P) const {
+    int rows = P.rows(), cols = P.cols();
+    DenseMatrix<T> Preal(rows, cols), Pimag(rows, cols);
+    Freal_.decompress_panel(p, Preal);
+    Fimag_.decompress_panel(p, Pimag);
     for (int j=0; j<cols; j++)
       for (int i=0; i<rows; i++)
-        F(i, j) = std::complex<T>(Freal(i,j), Fimag(i,j));
-    return;
+        P(i, j) = std::complex<T>(Preal(i,j), Pimag(i,j));
+  }
+
+  template<typename T> void LossyMatrix<std::complex<T>>::decompress
+  (DenseMatrix<std::complex<T>>& F) const {
+    if (!rows() || !cols()) return;
+    for (std::size_t p=0; p<panels(); p++) {
+      DenseMatrixWrapper<std::complex<T>> Fp
+        (rows(), panel_cols(p), F, 0, panel_begin(p));
+      decompress_panel(p, Fp);
+    }
   }
 
   // explicit template instantiations
@@ -124,13 +153,11 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixLossy<scalar_t,integer_t>::compress(const Opts_t& opts) {
-    uint prec = opts.lossy_precision();
+    auto prec = precision(opts);
     F11c_ = LossyMatrix<scalar_t>(this->F11_, prec);
     F12c_ = LossyMatrix<scalar_t>(this->F12_, prec);
     F21c_ = LossyMatrix<scalar_t>(this->F21_, prec);
-    this->F11_.clear();
-    this->F12_.clear();
-    this->F21_.clear();
+    this->release_factor_memory();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -151,23 +178,32 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixLossy<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
-    DenseM_t F11, F12, F21;
-    decompress(F11, F12, F21);
-    //FD_t::fwd_solve_phase2(b, bupd, etree_level, task_depth);
-    if (this->dim_sep()) {
-      DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
-      bloc.laswp(this->piv, true);
-      if (b.cols() == 1) {
-        trsv(UpLo::L, Trans::N, Diag::U, F11, bloc, task_depth);
-        if (this->dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F21, bloc,
-               scalar_t(1.), bupd, task_depth);
-      } else {
-        trsm(Side::L, UpLo::L, Trans::N, Diag::U,
-             scalar_t(1.), F11, bloc, task_depth);
-        if (this->dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F21, bloc,
-               scalar_t(1.), bupd, task_depth);
+    const std::size_t dsep = this->dim_sep(), dupd = this->dim_upd();
+    if (!dsep) return;
+    const std::size_t d = b.cols();
+    DenseMW_t bloc(dsep, d, b, this->sep_begin_, 0);
+    bloc.laswp(this->piv, true);
+    // decompress F11 and F21 one column panel at a time, and do a
+    // right-looking blocked forward substitution
+    DenseM_t buf(std::max(dsep, dupd), F11c_.panel_width());
+    for (std::size_t p=0; p<F11c_.panels(); p++) {
+      const std::size_t c0 = F11c_.panel_begin(p), nc = F11c_.panel_cols(p);
+      DenseMW_t L(dsep, nc, buf, 0, 0), x(nc, d, bloc, c0, 0);
+      F11c_.decompress_panel(p, L);
+      DenseMW_t Lkk(nc, nc, L, c0, 0);
+      trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+           scalar_t(1.), Lkk, x, task_depth);
+      if (c0+nc < dsep) {
+        DenseMW_t Lk(dsep-c0-nc, nc, L, c0+nc, 0),
+          bk(dsep-c0-nc, d, bloc, c0+nc, 0);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Lk, x,
+             scalar_t(1.), bk, task_depth);
+      }
+      if (dupd) {
+        DenseMW_t L21(dupd, nc, buf, 0, 0);
+        F21c_.decompress_panel(p, L21);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), L21, x,
+             scalar_t(1.), bupd, task_depth);
       }
     }
   }
@@ -175,22 +211,32 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixLossy<scalar_t,integer_t>::bwd_solve_phase1
   (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
-    DenseM_t F11, F12, F21;
-    decompress(F11, F12, F21);
-    // FD_t::bwd_solve_phase1(y, yupd, etree_level, task_depth);
-    if (this->dim_sep()) {
-      DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
-      if (y.cols() == 1) {
-        if (this->dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F12, yupd,
-               scalar_t(1.), yloc, task_depth);
-        trsv(UpLo::U, Trans::N, Diag::N, F11, yloc, task_depth);
-      } else {
-        if (this->dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F12, yupd,
-               scalar_t(1.), yloc, task_depth);
-        trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.),
-             F11, yloc, task_depth);
+    const std::size_t dsep = this->dim_sep(), dupd = this->dim_upd();
+    if (!dsep) return;
+    const std::size_t d = y.cols();
+    DenseMW_t yloc(dsep, d, y, this->sep_begin_, 0);
+    DenseM_t buf(dsep, F11c_.panel_width());
+    // decompress F12 and F11 one column panel at a time
+    if (dupd)
+      for (std::size_t p=0; p<F12c_.panels(); p++) {
+        const std::size_t c0 = F12c_.panel_begin(p), nc = F12c_.panel_cols(p);
+        DenseMW_t U12(dsep, nc, buf, 0, 0), yk(nc, d, yupd, c0, 0);
+        F12c_.decompress_panel(p, U12);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), U12, yk,
+             scalar_t(1.), yloc, task_depth);
+      }
+    // right-looking blocked backward substitution
+    for (std::size_t p=F11c_.panels(); p-- > 0; ) {
+      const std::size_t c0 = F11c_.panel_begin(p), nc = F11c_.panel_cols(p);
+      DenseMW_t U(dsep, nc, buf, 0, 0), x(nc, d, yloc, c0, 0);
+      F11c_.decompress_panel(p, U);
+      DenseMW_t Ukk(nc, nc, U, c0, 0);
+      trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+           scalar_t(1.), Ukk, x, task_depth);
+      if (c0) {
+        DenseMW_t Uk(c0, nc, U, 0, 0), yk(c0, d, yloc, 0, 0);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Uk, x,
+             scalar_t(1.), yk, task_depth);
       }
     }
   }
@@ -33,40 +33,75 @@
 
 namespace strumpack {
 
+  /**
+   * Dense matrix compressed with ZFP. The matrix is compressed in
+   * panels of (at most) panel_width() columns, which can be
+   * decompressed independently, so a solve can work through the
+   * matrix one panel at a time, with only a panel sized buffer.
+   * With prec <= 0, ZFP is used in reversible (lossless) mode.
+   */
   template<typename T> class LossyMatrix {
   public:
     LossyMatrix() {}
-    LossyMatrix(const DenseMatrix<T>& F, uint prec);
+    LossyMatrix(const DenseMatrix<T>& F, int prec,
+                std::size_t panel=default_panel_width);
     DenseMatrix<T> decompress() const {
       DenseMatrix<T> F(rows_, cols_);
       decompress(F);
       return F;
     }
     void decompress(DenseMatrix<T>& F) const;
+    /**
+     * Decompress panel p, columns [panel_begin(p), panel_begin(p) +
+     * panel_cols(p)), into P, which should be rows() x panel_cols(p).
+     */
+    void decompress_panel(std::size_t p, DenseMatrix<T>& P) const;
     std::size_t compressed_size() const { return buffer_.size(); }
     std::size_t rows() const { return rows_; }
     std::size_t cols() const { return cols_; }
+    std::size_t panels() const { return offsets_.size() - 1; }
+    std::size_t panel_width() const { return panel_; }
+    std::size_t panel_begin(std::size_t p) const { return p * panel_; }
+    std::size_t panel_cols(std::size_t p) const {
+      return std::min(panel_, cols_ - p * panel_);
+    }
+
+    // multiple of the ZFP block size (4)
+    static const std::size_t default_panel_width = 64;
+
   private:
-    std::size_t rows_ = 0, cols_ = 0;
-    uint prec_ = 16;
+    std::size_t rows_ = 0, cols_ = 0, panel_ = default_panel_width;
+    int prec_ = 16;
     std::vector<unsigned char> buffer_;
+    std::vector<std::size_t> offsets_ = {0};
   };
 
   template<typename T> class LossyMatrix<std::complex<T>> {
   public:
     LossyMatrix() {}
-    LossyMatrix(const DenseMatrix<std::complex<T>>& F, uint prec);
+    LossyMatrix(const DenseMatrix<std::complex<T>>& F, int prec,
+                std::size_t panel=LossyMatrix<T>::default_panel_width);
     DenseMatrix<std::complex<T>> decompress() const {
       DenseMatrix<std::complex<T>> F(rows(), cols());
       decompress(F);
       return F;
     }
     void decompress(DenseMatrix<std::complex<T>>& F) const;
+    void decompress_panel
+    (std::size_t p, DenseMatrix<std::complex<T>>& P) const;
     std::size_t compressed_size() const {
       return Freal_.compressed_size() + Fimag_.compressed_size();
     }
     std::size_t rows() const { return Freal_.rows(); }
     std::size_t cols() const { return Freal_.cols(); }
+    std::size_t panels() const { return Freal_.panels(); }
+    std::size_t panel_width() const { return Freal_.panel_width(); }
+    std::size_t panel_begin(std::size_t p) const {
+      return Freal_.panel_begin(p);
+    }
+    std::size_t panel_cols(std::size_t p) const {
+      return Freal_.panel_cols(p);
+    }
   private:
     LossyMatrix<T> Freal_, Fimag_;
   };
@@ -99,6 +134,19 @@ namespace strumpack {
 
     long long node_factor_nonzeros() const override;
 
+    void set_factor_store(FactorStore<scalar_t>* store,
+                          const F_t* next=nullptr) override {
+      // the compressed factors are kept in memory
+      F_t::set_factor_store(store, next);
+    }
+
+    void write_factors(std::ofstream& os) const override {
+      F_t::write_factors(os);
+    }
+    void read_factors(std::ifstream& is) override {
+      F_t::read_factors(is);
+    }
+
   private:
     LossyMatrix<scalar_t> F11c_, F12c_, F21c_;
 
@@ -109,6 +157,32 @@ namespace strumpack {
 
     FrontalMatrixLossy(const FrontalMatrixLossy&) = delete;
     FrontalMatrixLossy& operator=(FrontalMatrixLossy const&) = delete;
+
+  protected:
+    virtual int precision(const Opts_t& opts) const {
+      return opts.lossy_precision();
+    }
+  };
+
+
+  /**
+   * Front with the factors compressed using ZFP in reversible mode,
+   * so the factors are exact.
+   */
+  template<typename scalar_t,typename integer_t> class FrontalMatrixLossless
+    : public FrontalMatrixLossy<scalar_t,integer_t> {
+    using Opts_t = SPOptions<scalar_t>;
+
+  public:
+    FrontalMatrixLossless
+    (integer_t sep, integer_t sep_begin, integer_t sep_end,
+     std::vector<integer_t>& upd)
+      : FrontalMatrixLossy<scalar_t,integer_t>(sep, sep_begin, sep_end, upd) {}
+
+    std::string type() const override { return "FrontalMatrixLossless"; }
+
+  protected:
+    int precision(const Opts_t& opts) const override { return 0; }
   };
 
 
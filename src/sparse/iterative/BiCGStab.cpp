@@ -28,6 +28,7 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include "IterativeSolvers.hpp"
 
@@ -120,6 +121,141 @@ namespace strumpack {
       return error;
     }
 
+    /*
+     * BiCGStab for multiple right-hand sides, with the iterations for
+     * all columns done in lockstep. Columns that converge (or break
+     * down) are removed from the block to which A and M are applied.
+     */
+    template<typename scalar_t, typename real_t> real_t BlockBiCGStab
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      const std::size_t n = b.rows(), nrhs = b.cols();
+      DenseM_t r(n, nrhs), r_tld(n, nrhs), p_hat(n, nrhs), s_hat(n, nrhs),
+        p(n, nrhs), v(n, nrhs), s(n, nrhs), t(n, nrhs), W, Z;
+      std::vector<real_t> bnrm2(nrhs), error(nrhs, real_t(0.));
+      std::vector<scalar_t> alpha(nrhs, scalar_t(0.)), rho(nrhs),
+        rho_1(nrhs, scalar_t(0.)), omega(nrhs, scalar_t(1.));
+      std::vector<std::size_t> act, next;
+      for (std::size_t j=0; j<nrhs; j++) {
+        bnrm2[j] = blas::nrm2(n, b.ptr(0, j), 1);
+        if (bnrm2[j] == 0.0)
+          std::fill(x.ptr(0, j), x.ptr(0, j)+n, scalar_t(0.));
+        else act.push_back(j);
+      }
+      // Y(:,act) = A * X(:,act), or Y(:,act) = M \ X(:,act), A after M
+      auto apply = [&](const DenseM_t& X, DenseM_t* Y, DenseM_t* MX,
+                       const std::vector<std::size_t>& cols) {
+        auto na = cols.size();
+        if (!na) return;
+        W = DenseM_t(n, na);
+        for (std::size_t k=0; k<na; k++)
+          std::copy(X.ptr(0, cols[k]), X.ptr(0, cols[k])+n, W.ptr(0, k));
+        if (MX) {
+          M(W);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(W.ptr(0, k), W.ptr(0, k)+n, MX->ptr(0, cols[k]));
+        }
+        if (Y) {
+          Z = DenseM_t(n, na);
+          A(W, Z);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(Z.ptr(0, k), Z.ptr(0, k)+n, Y->ptr(0, cols[k]));
+        }
+      };
+      auto residual = [&](const std::vector<std::size_t>& cols) {
+        // r = b - A x
+        apply(x, &r, nullptr, cols);
+        for (auto j : cols)
+          blas::axpby(n, scalar_t(1.), b.ptr(0, j), 1,
+                      scalar_t(-1.), r.ptr(0, j), 1);
+      };
+      auto print = [&]() {
+        real_t e = 0.;
+        for (std::size_t j=0; j<nrhs; j++) e = std::max(e, error[j]);
+        std::cout << "BiCGStab it. " << totit << "\tmax rel.res = "
+                  << std::setw(12) << e << "\t(" << act.size() << "/"
+                  << nrhs << " rhs)" << std::endl;
+      };
+      if (non_zero_guess) residual(act);
+      else
+        for (auto j : act) {
+          std::copy(b.ptr(0, j), b.ptr(0, j)+n, r.ptr(0, j));
+          std::fill(x.ptr(0, j), x.ptr(0, j)+n, scalar_t(0.));
+        }
+      for (auto j : act) {
+        auto resid = blas::nrm2(n, r.ptr(0, j), 1);
+        error[j] = resid / bnrm2[j];
+        if (!(error[j] <= rtol || resid <= atol)) next.push_back(j);
+      }
+      act.swap(next);
+      if (verbose) print();
+      if (act.empty())
+        return *std::max_element(error.begin(), error.end());
+      r_tld.copy(r);
+      for (totit=1; totit<=maxit && !act.empty(); totit++) {
+        next.clear();
+        for (auto j : act) {
+          rho[j] = blas::dotc(n, r_tld.ptr(0, j), 1, r.ptr(0, j), 1);
+          if (rho[j] == scalar_t(0.0)) continue;
+          if (totit > 1) {
+            auto beta = (rho[j] / rho_1[j]) * (alpha[j] / omega[j]);
+            // p = r + beta (p - omega v)
+            blas::axpy(n, -omega[j], v.ptr(0, j), 1, p.ptr(0, j), 1);
+            blas::axpby(n, scalar_t(1), r.ptr(0, j), 1,
+                        beta, p.ptr(0, j), 1);
+          } else
+            std::copy(r.ptr(0, j), r.ptr(0, j)+n, p.ptr(0, j));
+          next.push_back(j);
+        }
+        act.swap(next);
+        apply(p, &v, &p_hat, act);    // p_hat = M \ p, v = A * p_hat
+        next.clear();
+        std::vector<std::size_t> early;
+        for (auto j : act) {
+          alpha[j] = rho[j] / blas::dotc(n, r_tld.ptr(0, j), 1, v.ptr(0, j), 1);
+          // s = r - alpha v
+          std::copy(r.ptr(0, j), r.ptr(0, j)+n, s.ptr(0, j));
+          blas::axpy(n, -alpha[j], v.ptr(0, j), 1, s.ptr(0, j), 1);
+          if (blas::nrm2(n, s.ptr(0, j), 1) < atol) { // early convergence
+            blas::axpy(n, alpha[j], p_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+            early.push_back(j);
+          } else next.push_back(j);
+        }
+        if (!early.empty()) {
+          residual(early);
+          for (auto j : early)
+            error[j] = blas::nrm2(n, r.ptr(0, j), 1) / bnrm2[j];
+        }
+        act.swap(next);
+        apply(s, &t, &s_hat, act);    // s_hat = M \ s, t = A * s_hat
+        next.clear();
+        for (auto j : act) {
+          // omega = ( t'*s) / ( t'*t );
+          omega[j] = blas::dotc(n, t.ptr(0, j), 1, s.ptr(0, j), 1) /
+            blas::dotc(n, t.ptr(0, j), 1, t.ptr(0, j), 1);
+          // x = x + alpha*p_hat + omega*s_hat
+          blas::axpy(n, alpha[j], p_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+          blas::axpy(n, omega[j], s_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+          // r = s - omega*t
+          std::copy(s.ptr(0, j), s.ptr(0, j)+n, r.ptr(0, j));
+          blas::axpy(n, -omega[j], t.ptr(0, j), 1, r.ptr(0, j), 1);
+          auto resid = blas::nrm2(n, r.ptr(0, j), 1);
+          error[j] = resid / bnrm2[j];
+          if (error[j] <= rtol || resid <= atol) continue;
+          if (omega[j] == scalar_t(0.0)) continue;
+          rho_1[j] = rho[j];
+          next.push_back(j);
+        }
+        act.swap(next);
+        if (verbose) print();
+        if (act.empty()) break;
+      }
+      return *std::max_element(error.begin(), error.end());
+    }
+
     // explicit template instantiations
     template float BiCGStab
     (const SPMV<float>& A, const PREC<float>& M, std::size_t n,
@@ -140,6 +276,31 @@ namespace strumpack {
      double rtol, double atol, int& totit, int maxit,
      bool non_zero_guess, bool verbose);
 
+    template float BlockBiCGStab
+    (const BlockSPMV<float>& A, const BlockPREC<float>& M,
+     DenseMatrix<float>& x, const DenseMatrix<float>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockBiCGStab
+    (const BlockSPMV<double>& A, const BlockPREC<double>& M,
+     DenseMatrix<double>& x, const DenseMatrix<double>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template float BlockBiCGStab
+    (const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockBiCGStab
+    (const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 
 } // end namespace strumpack
@@ -28,6 +28,8 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <numeric>
+#include <algorithm>
 
 #include "IterativeSolversMPI.hpp"
 
@@ -124,6 +126,180 @@ namespace strumpack {
       return error;
     }
 
+    /**
+     * BiCGStab for multiple right-hand sides, see BiCGStabMPI and
+     * BlockBiCGStab. The reductions for all columns are combined.
+     */
+    template<typename scalar_t, typename real_t> real_t BlockBiCGStabMPI
+    (const MPIComm& comm, const BlockSPMV<scalar_t>& A,
+     const BlockPREC<scalar_t>& M, DenseMatrix<scalar_t>& x,
+     const DenseMatrix<scalar_t>& b, real_t rtol, real_t atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      const std::size_t n = b.rows(), nrhs = b.cols();
+      DenseM_t r(n, nrhs), r_tld(n, nrhs), p_hat(n, nrhs), s_hat(n, nrhs),
+        p(n, nrhs), v(n, nrhs), s(n, nrhs), t(n, nrhs), W, Z;
+      std::vector<real_t> bnrm2(nrhs), error(nrhs, real_t(0.)), nrm;
+      std::vector<scalar_t> alpha(nrhs, scalar_t(0.)), rho(nrhs),
+        rho_1(nrhs, scalar_t(0.)), omega(nrhs, scalar_t(1.)), dots;
+      std::vector<std::size_t> all(nrhs), act, next;
+      std::iota(all.begin(), all.end(), 0);
+      // global norms of the columns cols of X
+      auto norms = [&](const DenseM_t& X,
+                       const std::vector<std::size_t>& cols) {
+        nrm.resize(cols.size());
+        for (std::size_t k=0; k<cols.size(); k++) {
+          auto nk = blas::nrm2(n, X.ptr(0, cols[k]), 1);
+          nrm[k] = nk * nk;
+        }
+        comm.all_reduce(nrm, MPI_SUM);
+        for (auto& nk : nrm) nk = std::sqrt(nk);
+      };
+      norms(b, all);
+      for (std::size_t j=0; j<nrhs; j++) {
+        bnrm2[j] = nrm[j];
+        if (bnrm2[j] == 0.0)
+          std::fill(x.ptr(0, j), x.ptr(0, j)+n, scalar_t(0.));
+        else act.push_back(j);
+      }
+      // Y(:,act) = A * X(:,act), or Y(:,act) = M \ X(:,act), A after M
+      auto apply = [&](const DenseM_t& X, DenseM_t* Y, DenseM_t* MX,
+                       const std::vector<std::size_t>& cols) {
+        auto na = cols.size();
+        if (!na) return;
+        W = DenseM_t(n, na);
+        for (std::size_t k=0; k<na; k++)
+          std::copy(X.ptr(0, cols[k]), X.ptr(0, cols[k])+n, W.ptr(0, k));
+        if (MX) {
+          M(W);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(W.ptr(0, k), W.ptr(0, k)+n, MX->ptr(0, cols[k]));
+        }
+        if (Y) {
+          Z = DenseM_t(n, na);
+          A(W, Z);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(Z.ptr(0, k), Z.ptr(0, k)+n, Y->ptr(0, cols[k]));
+        }
+      };
+      auto residual = [&](const std::vector<std::size_t>& cols) {
+        // r = b - A x
+        apply(x, &r, nullptr, cols);
+        for (auto j : cols)
+          blas::axpby(n, scalar_t(1.), b.ptr(0, j), 1,
+                      scalar_t(-1.), r.ptr(0, j), 1);
+      };
+      auto print = [&]() {
+        real_t e = 0.;
+        for (std::size_t j=0; j<nrhs; j++) e = std::max(e, error[j]);
+        std::cout << "BiCGStab it. " << totit << "\tmax rel.res = "
+                  << std::setw(12) << e << "\t(" << act.size() << "/"
+                  << nrhs << " rhs)" << std::endl;
+      };
+      if (non_zero_guess) residual(act);
+      else
+        for (auto j : act) {
+          std::copy(b.ptr(0, j), b.ptr(0, j)+n, r.ptr(0, j));
+          std::fill(x.ptr(0, j), x.ptr(0, j)+n, scalar_t(0.));
+        }
+      norms(r, act);
+      for (std::size_t k=0; k<act.size(); k++) {
+        auto j = act[k];
+        error[j] = nrm[k] / bnrm2[j];
+        if (!(nrm[k] <= atol || error[j] <= rtol)) next.push_back(j);
+      }
+      act.swap(next);
+      if (verbose) print();
+      if (act.empty())
+        return *std::max_element(error.begin(), error.end());
+      r_tld.copy(r);
+      for (totit=1; totit<=maxit && !act.empty(); totit++) {
+        dots.resize(act.size());
+        for (std::size_t k=0; k<act.size(); k++)
+          dots[k] = blas::dotc
+            (n, r_tld.ptr(0, act[k]), 1, r.ptr(0, act[k]), 1);
+        comm.all_reduce(dots, MPI_SUM);
+        next.clear();
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto j = act[k];
+          rho[j] = dots[k];
+          if (rho[j] == scalar_t(0.0)) continue;
+          if (totit > 1) {
+            auto beta = (rho[j] / rho_1[j]) * (alpha[j] / omega[j]);
+            // p = r + beta (p - omega v)
+            blas::axpy(n, -omega[j], v.ptr(0, j), 1, p.ptr(0, j), 1);
+            blas::axpby(n, scalar_t(1), r.ptr(0, j), 1,
+                        beta, p.ptr(0, j), 1);
+          } else
+            std::copy(r.ptr(0, j), r.ptr(0, j)+n, p.ptr(0, j));
+          next.push_back(j);
+        }
+        act.swap(next);
+        apply(p, &v, &p_hat, act);    // p_hat = M \ p, v = A * p_hat
+        dots.resize(act.size());
+        for (std::size_t k=0; k<act.size(); k++)
+          dots[k] = blas::dotc
+            (n, r_tld.ptr(0, act[k]), 1, v.ptr(0, act[k]), 1);
+        comm.all_reduce(dots, MPI_SUM);
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto j = act[k];
+          alpha[j] = rho[j] / dots[k];
+          // s = r - alpha v
+          std::copy(r.ptr(0, j), r.ptr(0, j)+n, s.ptr(0, j));
+          blas::axpy(n, -alpha[j], v.ptr(0, j), 1, s.ptr(0, j), 1);
+        }
+        norms(s, act);
+        next.clear();
+        std::vector<std::size_t> early;
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto j = act[k];
+          if (nrm[k] < atol) {                    // early convergence
+            blas::axpy(n, alpha[j], p_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+            early.push_back(j);
+          } else next.push_back(j);
+        }
+        if (!early.empty()) {
+          residual(early);
+          norms(r, early);
+          for (std::size_t k=0; k<early.size(); k++)
+            error[early[k]] = nrm[k] / bnrm2[early[k]];
+        }
+        act.swap(next);
+        apply(s, &t, &s_hat, act);    // s_hat = M \ s, t = A * s_hat
+        dots.resize(2*act.size());
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto j = act[k];
+          dots[2*k] = blas::dotc(n, t.ptr(0, j), 1, s.ptr(0, j), 1);
+          dots[2*k+1] = blas::dotc(n, t.ptr(0, j), 1, t.ptr(0, j), 1);
+        }
+        comm.all_reduce(dots, MPI_SUM);
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto j = act[k];
+          omega[j] = dots[2*k] / dots[2*k+1];   // omega = ( t'*s) / ( t'*t );
+          // x = x + alpha*p_hat + omega*s_hat
+          blas::axpy(n, alpha[j], p_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+          blas::axpy(n, omega[j], s_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+          // r = s - omega*t
+          std::copy(s.ptr(0, j), s.ptr(0, j)+n, r.ptr(0, j));
+          blas::axpy(n, -omega[j], t.ptr(0, j), 1, r.ptr(0, j), 1);
+        }
+        norms(r, act);
+        next.clear();
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto j = act[k];
+          error[j] = nrm[k] / bnrm2[j];
+          if (nrm[k] <= atol || error[j] <= rtol) continue;
+          if (omega[j] == scalar_t(0.0)) continue;
+          rho_1[j] = rho[j];
+          next.push_back(j);
+        }
+        act.swap(next);
+        if (verbose) print();
+        if (act.empty()) break;
+      }
+      return *std::max_element(error.begin(), error.end());
+    }
+
     // explicit template instantiations
     template float BiCGStabMPI
     (const MPIComm& comm, const SPMV<float>& A, const PREC<float>& M,
@@ -146,5 +322,28 @@ namespace strumpack {
      double rtol, double atol, int& totit, int maxit,
      bool non_zero_guess, bool verbose);
 
+    template float BlockBiCGStabMPI
+    (const MPIComm& comm, const BlockSPMV<float>& A,
+     const BlockPREC<float>& M, DenseMatrix<float>& x,
+     const DenseMatrix<float>& b, float rtol, float atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template double BlockBiCGStabMPI
+    (const MPIComm& comm, const BlockSPMV<double>& A,
+     const BlockPREC<double>& M, DenseMatrix<double>& x,
+     const DenseMatrix<double>& b, double rtol, double atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template float BlockBiCGStabMPI
+    (const MPIComm& comm, const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b, float rtol, float atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template double BlockBiCGStabMPI
+    (const MPIComm& comm, const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b, double rtol, double atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 } // end namespace strumpack
@@ -28,6 +28,8 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <numeric>
+#include <algorithm>
 
 #include "IterativeSolversMPI.hpp"
 
@@ -150,6 +152,193 @@ namespace strumpack {
       return rho;
     }
 
+    /**
+     * Left preconditioned restarted GMRes for multiple right-hand
+     * sides, see GMResMPI. The reductions for all the columns are
+     * combined into a single all_reduce.
+     */
+    template<typename scalar_t, typename real_t> real_t BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<scalar_t>& A,
+     const BlockPREC<scalar_t>& M, DenseMatrix<scalar_t>& x,
+     const DenseMatrix<scalar_t>& b, real_t rtol, real_t atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      if (restart > maxit) restart = maxit;
+      const std::size_t n = b.rows(), nrhs = b.cols();
+      const int ldh = restart+1;
+      std::vector<DenseM_t> V(nrhs, DenseM_t(n, restart+1));
+      DenseM_t hess(ldh, restart*nrhs), b_(restart+1, nrhs),
+        givens_c(restart, nrhs), givens_s(restart, nrhs);
+      DenseM_t b_prec(b);
+      M(b_prec);
+      std::vector<real_t> rho(nrhs), rho0(nrhs), nrm;
+      std::vector<scalar_t> dots;
+      // a zero right-hand side has solution zero, it is not iterated
+      std::vector<std::size_t> act;
+      {
+        std::vector<real_t> bnrm(nrhs);
+        for (std::size_t j=0; j<nrhs; j++) {
+          auto nj = blas::nrm2(n, b.ptr(0, j), 1);
+          bnrm[j] = nj * nj;
+        }
+        comm.all_reduce(bnrm, MPI_SUM);
+        for (std::size_t j=0; j<nrhs; j++) {
+          if (bnrm[j] == real_t(0.))
+            std::fill(x.ptr(0, j), x.ptr(0, j)+n, scalar_t(0.));
+          else act.push_back(j);
+        }
+      }
+      // norms of column c of V[j], for all j in act
+      auto norms = [&](int c) {
+        nrm.resize(act.size());
+        for (std::size_t k=0; k<act.size(); k++) {
+          auto nk = blas::nrm2(n, V[act[k]].ptr(0, c), 1);
+          nrm[k] = nk * nk;
+        }
+        comm.all_reduce(nrm, MPI_SUM);
+        for (auto& nk : nrm) nk = std::sqrt(nk);
+      };
+      auto update_x = [&](std::size_t j, int nrit) {
+        auto h = hess.ptr(0, j*restart);
+        blas::trsv('U', 'N', 'N', nrit+1, h, ldh, b_.ptr(0, j), 1);
+        blas::gemv('N', n, nrit+1, scalar_t(1.), V[j].data(), V[j].ld(),
+                   b_.ptr(0, j), 1, scalar_t(1.), x.ptr(0, j), 1);
+      };
+      auto print = [&](bool restarted) {
+        real_t r = 0., rr = 0.;
+        for (auto j : act) {
+          r = std::max(r, rho[j]);
+          rr = std::max(rr, rho[j]/rho0[j]);
+        }
+        std::cout << "GMRES it. " << totit << "\tmax res = "
+                  << std::setw(12) << r << "\tmax rel.res = "
+                  << std::setw(12) << rr << "\t(" << act.size() << "/"
+                  << nrhs << " rhs)" << (restarted ? "\t restart!" : "")
+                  << std::endl;
+      };
+      totit = 0;
+      DenseM_t W, Z;
+      while (!act.empty()) {
+        auto na = act.size();
+        if (non_zero_guess || totit > 0) {
+          W = DenseM_t(n, na);
+          Z = DenseM_t(n, na);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(x.ptr(0, act[k]), x.ptr(0, act[k])+n, W.ptr(0, k));
+          A(W, Z);
+          M(Z);
+          for (std::size_t k=0; k<na; k++) {
+            auto j = act[k];
+            for (std::size_t i=0; i<n; i++)
+              V[j](i, 0) = b_prec(i, j) - Z(i, k);
+          }
+        } else {
+          for (auto j : act) {
+            std::copy(b_prec.ptr(0, j), b_prec.ptr(0, j)+n, V[j].data());
+            std::fill(x.ptr(0, j), x.ptr(0, j)+n, scalar_t(0.));
+          }
+        }
+        norms(0);
+        std::vector<std::size_t> next;
+        for (std::size_t k=0; k<na; k++) {
+          auto j = act[k];
+          rho[j] = nrm[k];
+          if (totit == 0) rho0[j] = rho[j];
+          // rho0 is zero if the initial guess is exact
+          if (rho[j] == real_t(0.) || rho[j] < atol ||
+              rho[j]/rho0[j] < rtol) continue;
+          blas::scal(n, scalar_t(1./rho[j]), V[j].data(), 1);
+          b_(0, j) = rho[j];
+          for (int i=1; i<=restart; i++) b_(i, j) = scalar_t(0.);
+          next.push_back(j);
+        }
+        act.swap(next);
+        if (act.empty()) break;
+        if (verbose) print(true);
+        for (int it=0; it<restart; it++) {
+          totit++;
+          na = act.size();
+          W = DenseM_t(n, na);
+          Z = DenseM_t(n, na);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(V[act[k]].ptr(0, it), V[act[k]].ptr(0, it)+n,
+                      W.ptr(0, k));
+          A(W, Z);
+          M(Z);
+          for (std::size_t k=0; k<na; k++)
+            std::copy(Z.ptr(0, k), Z.ptr(0, k)+n, V[act[k]].ptr(0, it+1));
+          if (GStype == GramSchmidtType::CLASSICAL) {
+            dots.resize(na*(it+1));
+            for (std::size_t k=0; k<na; k++)
+              blas::gemv('C', n, it+1, scalar_t(1.), V[act[k]].data(), n,
+                         V[act[k]].ptr(0, it+1), 1, scalar_t(0.),
+                         &dots[k*(it+1)], 1);
+            comm.all_reduce(dots, MPI_SUM);
+            for (std::size_t k=0; k<na; k++) {
+              auto j = act[k];
+              auto h = hess.ptr(0, j*restart);
+              std::copy(&dots[k*(it+1)], &dots[(k+1)*(it+1)], &h[it*ldh]);
+              blas::gemv('N', n, it+1, scalar_t(-1.), V[j].data(), n,
+                         &h[it*ldh], 1, scalar_t(1.), V[j].ptr(0, it+1), 1);
+            }
+          } else if (GStype == GramSchmidtType::MODIFIED) {
+            dots.resize(na);
+            for (int l=0; l<=it; l++) {
+              for (std::size_t k=0; k<na; k++)
+                dots[k] = blas::dotc(n, V[act[k]].ptr(0, l), 1,
+                                     V[act[k]].ptr(0, it+1), 1);
+              comm.all_reduce(dots, MPI_SUM);
+              for (std::size_t k=0; k<na; k++) {
+                auto j = act[k];
+                hess.ptr(0, j*restart)[l+it*ldh] = dots[k];
+                blas::axpy(n, -dots[k], V[j].ptr(0, l), 1,
+                           V[j].ptr(0, it+1), 1);
+              }
+            }
+          }
+          norms(it+1);
+          next.clear();
+          for (std::size_t k=0; k<na; k++) {
+            auto j = act[k];
+            auto h = hess.ptr(0, j*restart);
+            auto gc = givens_c.ptr(0, j);
+            auto gs = givens_s.ptr(0, j);
+            auto bj = b_.ptr(0, j);
+            h[it+1+it*ldh] = nrm[k];
+            blas::scal(n, scalar_t(1.)/h[it+1+it*ldh], V[j].ptr(0, it+1), 1);
+            for (int l=1; l<it+1; l++) {
+              scalar_t gamma = blas::my_conj(gc[l-1])*h[l-1+it*ldh]
+                + blas::my_conj(gs[l-1])*h[l+it*ldh];
+              h[l+it*ldh] = -gs[l-1]*h[l-1+it*ldh] + gc[l-1]*h[l+it*ldh];
+              h[l-1+it*ldh] = gamma;
+            }
+            scalar_t delta =
+              std::sqrt(std::pow(std::abs(h[it+it*ldh]),scalar_t(2))
+                        + std::pow(h[it+1+it*ldh],scalar_t(2)));
+            gc[it] = h[it+it*ldh] / delta;
+            gs[it] = h[it+1+it*ldh] / delta;
+            h[it+it*ldh] = blas::my_conj(gc[it])*h[it+it*ldh]
+              + blas::my_conj(gs[it])*h[it+1+it*ldh];
+            bj[it+1] = -gs[it]*bj[it];
+            bj[it] = blas::my_conj(gc[it])*bj[it];
+            rho[j] = std::abs(bj[it+1]);
+            if (rho[j] < atol || rho[j]/rho0[j] < rtol || totit >= maxit)
+              update_x(j, it);
+            else next.push_back(j);
+          }
+          if (verbose) print(false);
+          if (next.empty() || it == restart-1) {
+            for (auto j : next) update_x(j, it);
+            act.swap(next);
+            break;
+          }
+          act.swap(next);
+        }
+      }
+      return *std::max_element(rho.begin(), rho.end());
+    }
+
     // explicit template instantiations
     template float GMResMPI
     (const MPIComm& comm, const SPMV<float>& A, const PREC<float>& M,
@@ -174,5 +363,32 @@ namespace strumpack {
      double rtol, double atol, int& totit, int maxit, int restart,
      GramSchmidtType GStype, bool non_zero_guess, bool verbose);
 
+    template float BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<float>& A,
+     const BlockPREC<float>& M, DenseMatrix<float>& x,
+     const DenseMatrix<float>& b, float rtol, float atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template double BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<double>& A,
+     const BlockPREC<double>& M, DenseMatrix<double>& x,
+     const DenseMatrix<double>& b, double rtol, double atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template float BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b, float rtol, float atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template double BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b, double rtol, double atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 } // end namespace strumpack
@@ -45,6 +45,10 @@ namespace strumpack {
 
     template<typename T> using SPMV = std::function<void(const T*, T*)>;
     template<typename T> using PREC = std::function<void(T*)>;
+    template<typename T> using BlockSPMV =
+      std::function<void(const DenseMatrix<T>&, DenseMatrix<T>&)>;
+    template<typename T> using BlockPREC =
+      std::function<void(DenseMatrix<T>&)>;
 
     /*
      * This is left preconditioned restarted GMRes.
@@ -70,6 +74,40 @@ namespace strumpack {
      scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
      int& totit, int maxit, bool non_zero_guess, bool verbose);
 
+    /**
+     * Left preconditioned restarted GMRes for multiple right-hand
+     * sides. Every column has its own Krylov space, but the operator
+     * A and preconditioner M are applied to a block with all
+     * non-converged columns at once, so M can run at BLAS3 rates.
+     *
+     * \param x on output the solution, on input the initial guess if
+     * non_zero_guess, same size as b
+     * \return the maximum (over the columns) residual norm
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockGMRes
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+
+    /**
+     * Preconditioned BiCGStab for multiple right-hand sides, see
+     * BiCGStab. The iterations for the different columns are done in
+     * lockstep, with A and M applied to the block of all
+     * non-converged columns.
+     *
+     * \return the maximum (over the columns) relative residual
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockBiCGStab
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
     /**
      * Iterative refinement, with a sparse matrix, to solve a linear
      * system M^{-1}Ax=M^{-1}b.
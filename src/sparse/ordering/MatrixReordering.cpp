@@ -30,6 +30,7 @@
 #include <string>
 #include <algorithm>
 #include <memory>
+#include <stdexcept>
 
 #include "MatrixReordering.hpp"
 
@@ -108,6 +109,9 @@ namespace strumpack {
       return 1;
     }
     sep_tree_->check();
+    if (opts.amalgamation_tol() > 0)
+      sep_tree_ = sep_tree_->amalgamate
+        (A.ptr(), A.ind(), perm_, opts.amalgamation_tol());
     nested_dissection_print(opts, A.nnz(), opts.verbose());
     return 0;
   }
@@ -121,6 +125,9 @@ namespace strumpack {
     else for (std::size_t i=0; i<n; i++) perm_[i] = p[i] - base;
     sep_tree_ = build_sep_tree_from_perm(A.ptr(), A.ind(), perm_, iperm_);
     sep_tree_->check();
+    if (opts.amalgamation_tol() > 0)
+      sep_tree_ = sep_tree_->amalgamate
+        (A.ptr(), A.ind(), perm_, opts.amalgamation_tol());
     nested_dissection_print(opts, A.nnz(), opts.verbose());
     return 0;
   }
@@ -227,6 +234,34 @@ namespace strumpack {
     sep_tree_ = nullptr;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::write(std::ofstream& os) const {
+    std::size_t n = perm_.size();
+    os.write((const char*)&n, sizeof(n));
+    os.write((const char*)perm_.data(), n*sizeof(integer_t));
+    os.write((const char*)iperm_.data(), n*sizeof(integer_t));
+    sep_tree_->write(os);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::read
+  (std::ifstream& is, integer_t n) {
+    std::size_t nf = 0;
+    is.read((char*)&nf, sizeof(nf));
+    if (!is || nf != std::size_t(n))
+      throw std::runtime_error("Invalid permutation in file");
+    perm_.resize(n);
+    iperm_.resize(n);
+    is.read((char*)perm_.data(), n*sizeof(integer_t));
+    is.read((char*)iperm_.data(), n*sizeof(integer_t));
+    if (!is)
+      throw std::runtime_error("Invalid permutation in file");
+    for (integer_t i=0; i<n; i++)
+      if (perm_[i] < 0 || perm_[i] >= n || iperm_[perm_[i]] != i)
+        throw std::runtime_error("Invalid permutation in file");
+    sep_tree_ = SeparatorTree<integer_t>::read(is, n);
+  }
+
   // reorder the vertices in the separator to get a better rank structure
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::separator_reordering
@@ -294,6 +329,9 @@ namespace strumpack {
       }
       std::cout << "#   - strategy parameter = "
                 << opts.nd_param() << std::endl;
+      if (opts.amalgamation_tol() > 0)
+        std::cout << "#   - amalgamation tolerance = "
+                  << opts.amalgamation_tol() << std::endl;
       std::cout << "#   - number of separators = "
                 << number_format_with_commas(total_separators) << std::endl;
       std::cout << "#   - number of levels = "
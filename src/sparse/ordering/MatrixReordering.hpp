@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <memory>
+#include <fstream>
 
 #include "StrumpackOptions.hpp"
 #include "StrumpackConfig.hpp"
@@ -76,6 +77,14 @@ namespace strumpack {
 
     virtual void clear_tree_data();
 
+    void write(std::ofstream& os) const;
+    /**
+     * Read the permutation and separator tree for a matrix with n
+     * rows, as written by write. Throws a std::runtime_error if the
+     * data is not valid.
+     */
+    void read(std::ifstream& is, integer_t n);
+
     const std::vector<integer_t>& perm() const { return perm_; }
     const std::vector<integer_t>& iperm() const { return iperm_; }
 
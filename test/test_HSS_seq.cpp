@@ -151,6 +151,24 @@ int run(int argc, char* argv[]) {
     return 1;
   }
 
+  if (hss_opts.incremental_compression()) {
+    // the incremental compression should be about as accurate as
+    // the default, non-incremental, compression
+    auto opts0 = hss_opts;
+    opts0.set_incremental_compression(false);
+    HSSMatrix<double> H0(A, opts0);
+    auto H0dense = H0.dense();
+    H0dense.scaled_add(-1., A);
+    auto err = Hdense.normF() / A.normF(),
+      err0 = H0dense.normF() / A.normF();
+    cout << "# non-incremental: rank(H) = " << H0.rank()
+         << ", relative error = " << err0 << endl;
+    if (err > 10. * max(err0, 1e-14)) {
+      cout << "ERROR: incremental compression error too big!!" << endl;
+      return 1;
+    }
+  }
+
   if (!H.leaf()) {
     double beta = 0.;
     HSSMatrix<double>* H0 = H.child(0);
@@ -0,0 +1,162 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+#include <cmath>
+using namespace std;
+
+#include "kernel/KernelRegression.hpp"
+using namespace strumpack;
+using namespace strumpack::kernel;
+
+#define ERROR_TOLERANCE 1e-12
+
+
+/**
+ * Compare the kernel submatrix K(I,J), computed in blocks, and the
+ * prediction against a direct evaluation of the kernel function
+ * kf. The points are far from the origin, with some near
+ * duplicates, to expose cancellation in the blocked distances.
+ */
+template<typename F> int
+check_kernel(const string& name, Kernel<double>& K, F kf, double lambda,
+             const DenseMatrix<double>& test) {
+  auto& X = K.data();
+  const std::size_t n = K.n(), d = K.d();
+  auto direct = [&](const double* x, const double* y) {
+    return kf(d, x, y);
+  };
+  vector<size_t> I, J;
+  for (size_t i=0; i<n; i+=2) I.push_back(i);
+  for (size_t j=0; j<n; j+=3) J.push_back(j);
+  J.push_back(1);
+  DenseMatrix<double> B(I.size(), J.size());
+  K(I, J, B);
+  double err = 0.;
+  for (size_t j=0; j<J.size(); j++)
+    for (size_t i=0; i<I.size(); i++) {
+      auto Kij = direct(X.ptr(0, I[i]), X.ptr(0, J[j])) +
+        ((I[i] == J[j]) ? lambda : 0.);
+      err = max(err, abs(B(i, j) - Kij) / max(1., abs(Kij)));
+    }
+  cout << "# " << name << " max rel. error K(I,J) = " << err << endl;
+  if (err > ERROR_TOLERANCE) return 1;
+
+  DenseMatrix<double> w(n, 1);
+  for (size_t i=0; i<n; i++) w(i, 0) = (i % 2) ? 1. : -.5;
+  auto p = K.predict(test, w);
+  double perr = 0.;
+  for (size_t t=0; t<test.cols(); t++) {
+    double pt = 0., pa = 0.;
+    for (size_t i=0; i<n; i++) {
+      auto k = direct(X.ptr(0, i), test.ptr(0, t)) * w(i, 0);
+      pt += k;
+      pa += abs(k);
+    }
+    perr = max(perr, abs(p[t] - pt) / max(1., pa));
+  }
+  cout << "# " << name << " max rel. error predict = " << perr << endl;
+  return (perr > ERROR_TOLERANCE) ? 1 : 0;
+}
+
+/**
+ * A user defined kernel which only overrides eval, K(I,J) should
+ * use it instead of the kernel function of the base class.
+ */
+class ScaledGaussKernel : public GaussKernel<double> {
+public:
+  ScaledGaussKernel(DenseMatrix<double>& data, double h, double lambda)
+    : GaussKernel<double>(data, h, lambda) {}
+  double eval(size_t i, size_t j) const override {
+    return 2. * GaussKernel<double>::eval(i, j);
+  }
+};
+
+int check_eval_override(DenseMatrix<double>& X, double h, double lambda) {
+  ScaledGaussKernel K(X, h, lambda);
+  vector<size_t> I, J;
+  for (size_t i=0; i<K.n(); i+=7) I.push_back(i);
+  for (size_t j=0; j<K.n(); j+=5) J.push_back(j);
+  DenseMatrix<double> B(I.size(), J.size());
+  K(I, J, B);
+  double err = 0.;
+  for (size_t j=0; j<J.size(); j++)
+    for (size_t i=0; i<I.size(); i++)
+      err = max(err, abs(B(i, j) - K.eval(I[i], J[j])));
+  cout << "# user eval override max error K(I,J) = " << err << endl;
+  return (err > ERROR_TOLERANCE) ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+  const size_t d = 4, n = 300, m = 50;
+  const double h = 1.3, lambda = .1, offset = 1e3;
+  DenseMatrix<double> X(d, n), test(d, m);
+  mt19937 gen(1);
+  normal_distribution<double> nd;
+  for (size_t j=0; j<n; j++)
+    for (size_t k=0; k<d; k++)
+      X(k, j) = (j % 10 == 9) ?
+        X(k, j-1) + 1e-7 * nd(gen) : offset + nd(gen);
+  for (size_t j=0; j<m; j++)
+    for (size_t k=0; k<d; k++)
+      test(k, j) = (j % 5 == 0) ? X(k, j) : offset + nd(gen);
+
+  int ierr = 0;
+  {
+    GaussKernel<double> K(X, h, lambda);
+    ierr += check_kernel
+      ("Gauss", K, [&](size_t d, const double* x, const double* y) {
+        double r = 0.;
+        for (size_t k=0; k<d; k++) r += (x[k] - y[k]) * (x[k] - y[k]);
+        return exp(-r / (2. * h * h)); }, lambda, test);
+  }
+  {
+    LaplaceKernel<double> K(X, h, lambda);
+    ierr += check_kernel
+      ("Laplace", K, [&](size_t d, const double* x, const double* y) {
+        double r = 0.;
+        for (size_t k=0; k<d; k++) r += abs(x[k] - y[k]);
+        return exp(-r / h); }, lambda, test);
+  }
+  {
+    // ANOVA of degree 2: sum over all pairs of features of the
+    // products of the 1d Gauss kernels
+    ANOVAKernel<double> K(X, h, lambda, 2);
+    ierr += check_kernel
+      ("ANOVA", K, [&](size_t d, const double* x, const double* y) {
+        double r = 0.;
+        for (size_t k=0; k<d; k++)
+          for (size_t l=k+1; l<d; l++)
+            r += exp(-((x[k]-y[k])*(x[k]-y[k]) + (x[l]-y[l])*(x[l]-y[l]))
+                     / (2. * h * h));
+        return r; }, lambda, test);
+  }
+  ierr += check_eval_override(X, h, lambda);
+  return ierr ? 1 : 0;
+}
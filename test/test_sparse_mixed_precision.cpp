@@ -0,0 +1,126 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <complex>
+using namespace std;
+
+#include "StrumpackSparseSolverMixedPrecision.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "misc/RandomWrapper.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+
+template<typename factor_t,typename refine_t,typename integer_t> int
+test_sparse_solver(int argc, char* argv[],
+                   CSRMatrix<refine_t,integer_t>& A) {
+  using real_t = typename RealType<refine_t>::value_type;
+  StrumpackSparseSolverMixedPrecision<factor_t,refine_t,integer_t> spss;
+  spss.set_from_options(argc, argv);
+
+  int N = A.size();
+  vector<refine_t> b(N), x(N), x_exact(N);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (auto& xi : x_exact)
+      xi = refine_t(rgen->get());
+  }
+  A.spmv(x_exact.data(), b.data());
+
+  spss.set_matrix(A);
+  if (spss.reorder() != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  if (spss.solve(b.data(), x.data()) != ReturnCode::SUCCESS) {
+    cout << "problem during the solve." << endl;
+    return 1;
+  }
+
+  // the factorization is only accurate to factor_t precision, the
+  // refinement should still reach the refine_t tolerance
+  auto comp_scal_res = A.max_scaled_residual(x.data(), b.data());
+  cout << "# COMPONENTWISE SCALED RESIDUAL = "
+       << comp_scal_res << endl;
+
+  blas::axpy(N, refine_t(-1.), x_exact.data(), 1, x.data(), 1);
+  auto nrm_error = blas::nrm2(N, x.data(), 1);
+  auto nrm_x_exact = blas::nrm2(N, x_exact.data(), 1);
+  cout << "# RELATIVE ERROR = " << (nrm_error/nrm_x_exact) << endl;
+
+  if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+    return 1;
+  else return 0;
+}
+
+
+template<typename integer_t>
+int read_matrix_and_run_tests(int argc, char* argv[]) {
+  string f(argv[1]);
+  CSRMatrix<double,integer_t> A;
+  if (A.read_matrix_market(f) == 0)
+    return test_sparse_solver<float,double,integer_t>(argc, argv, A);
+  else {
+    CSRMatrix<complex<double>,integer_t> Acomplex;
+    if (Acomplex.read_matrix_market(f)) {
+      std::cerr << "Could not read matrix from file." << std::endl;
+      return 1;
+    }
+    return test_sparse_solver<complex<float>,complex<double>,integer_t>
+      (argc, argv, Acomplex);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve a linear system with a matrix given in matrix market format\n"
+      << "using a single precision factorization and iterative refinement\n"
+      << "in double precision.\n\n"
+      << "Usage: \n\t./test_sparse_mixed_precision pde900.mtx" << endl;
+    return 1;
+  }
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+
+  int ierr = read_matrix_and_run_tests<int>(argc, argv);
+  if (ierr) return ierr;
+  ierr = read_matrix_and_run_tests<long long int>(argc, argv);
+  return ierr;
+}
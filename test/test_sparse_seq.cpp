@@ -28,6 +28,9 @@
  */
 #include <iostream>
 #include <cstring>
+#include <cstdio>
+#include <string>
+#include <random>
 using namespace std;
 
 #include "StrumpackSparseSolver.hpp"
@@ -39,6 +42,52 @@ using namespace strumpack;
 #define ERROR_TOLERANCE 1e2
 #define SOLVE_TOLERANCE 1e-12
 
+// factor A, then change the values (scale row and column i with
+// 1 + i % s, so a symmetric positive definite matrix stays symmetric
+// positive definite) with update_matrix_values and solve with the new
+// matrix. This is done twice, with --sp_enable_assembly_maps the
+// first update sets up the map from the input values to the permuted
+// matrix, and the second update uses that map.
+template<typename scalar_t,typename integer_t> int
+test_update_values(int argc, const char* const argv[],
+                   const CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  if (spss.reorder() != ReturnCode::SUCCESS ||
+      spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  integer_t N = A.size();
+  vector<scalar_t> b(N), x(N), x_exact(N);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (auto& xi : x_exact)
+      xi = rgen->get();
+  }
+  for (int s=2; s<=3; s++) {
+    CSRMatrix<scalar_t,integer_t> B(A);
+    for (integer_t i=0; i<N; i++)
+      for (integer_t k=B.ptr(i); k<B.ptr(i+1); k++)
+        B.val(k) *= scalar_t((1 + i % s) * (1 + B.ind(k) % s));
+    B.spmv(x_exact.data(), b.data());
+    spss.update_matrix_values(B);
+    if (spss.solve(b.data(), x.data()) != ReturnCode::SUCCESS) {
+      cout << "problem during the solve after updating the values."
+           << endl;
+      return 1;
+    }
+    auto comp_scal_res = B.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (UPDATED VALUES " << s-1
+         << ") = " << comp_scal_res << endl;
+    if (!(comp_scal_res <= ERROR_TOLERANCE*spss.options().rel_tol()))
+      return 1;
+  }
+  return 0;
+}
+
 template<typename scalar_t,typename integer_t> int
 test_sparse_solver(int argc, const char* const argv[],
                    CSRMatrix<scalar_t,integer_t>& A) {
@@ -64,7 +113,10 @@ test_sparse_solver(int argc, const char* const argv[],
     cout << "problem during factorization of the matrix." << endl;
     return 1;
   }
-  spss.solve(b.data(), x.data());
+  if (spss.solve(b.data(), x.data()) != ReturnCode::SUCCESS) {
+    cout << "problem during the solve." << endl;
+    return 1;
+  }
 
   auto comp_scal_res = A.max_scaled_residual(x.data(), b.data());
   cout << "# COMPONENTWISE SCALED RESIDUAL = "
@@ -75,7 +127,72 @@ test_sparse_solver(int argc, const char* const argv[],
   auto nrm_x_exact = blas::nrm2(N, x_exact.data(), 1);
   cout << "# RELATIVE ERROR = " << (nrm_error/nrm_x_exact) << endl;
 
-  if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+  if (!(comp_scal_res <= ERROR_TOLERANCE*spss.options().rel_tol()))
+    return 1;
+
+  // solve with multiple right-hand sides, for the Krylov solvers this
+  // uses the block variants
+  // the last right-hand side is zero, the Krylov solvers should not
+  // iterate on it and return a zero solution
+  int nrhs = 3;
+  DenseMatrix<scalar_t> B(N, nrhs), X(N, nrhs), X_exact(N, nrhs);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (int c=0; c<nrhs-1; c++)
+      for (int i=0; i<N; i++)
+        X_exact(i, c) = rgen->get();
+    for (int i=0; i<N; i++)
+      X_exact(i, nrhs-1) = scalar_t(0.);
+  }
+  A.spmv(X_exact, B);
+  if (spss.solve(B, X) != ReturnCode::SUCCESS) {
+    cout << "problem during the solve." << endl;
+    return 1;
+  }
+
+  auto comp_scal_res_multi = A.max_scaled_residual(X, B);
+  cout << "# COMPONENTWISE SCALED RESIDUAL (" << nrhs << " RHS) = "
+       << comp_scal_res_multi << endl;
+
+  if (!(comp_scal_res_multi <= ERROR_TOLERANCE*spss.options().rel_tol()))
+    return 1;
+  for (int i=0; i<N; i++)
+    if (X(i, nrhs-1) != scalar_t(0.)) {
+      cout << "nonzero solution for a zero right-hand side." << endl;
+      return 1;
+    }
+
+  if (test_update_values(argc, argv, A))
+    return 1;
+
+  // write the factors to a file, read them in a new solver and solve
+  // again, only supported without compression
+  if (spss.options().compression() != CompressionType::NONE)
+    return 0;
+  string fname = "test_sparse_seq_factors_" +
+    to_string(random_device{}()) + ".bin";
+  if (spss.save_factors(fname) != ReturnCode::SUCCESS) {
+    cout << "problem writing the factors." << endl;
+    remove(fname.c_str());
+    return 1;
+  }
+  StrumpackSparseSolver<scalar_t,integer_t> spss_load;
+  spss_load.options().set_from_command_line(argc, argv);
+  spss_load.set_matrix(A);
+  auto ierr = spss_load.load_factors(fname);
+  remove(fname.c_str());
+  if (ierr != ReturnCode::SUCCESS) {
+    cout << "problem reading the factors." << endl;
+    return 1;
+  }
+  if (spss_load.solve(b.data(), x.data()) != ReturnCode::SUCCESS) {
+    cout << "problem during the solve with the loaded factors." << endl;
+    return 1;
+  }
+  auto comp_scal_res_load = A.max_scaled_residual(x.data(), b.data());
+  cout << "# COMPONENTWISE SCALED RESIDUAL (LOADED FACTORS) = "
+       << comp_scal_res_load << endl;
+  if (!(comp_scal_res_load <= ERROR_TOLERANCE*spss.options().rel_tol()))
     return 1;
   else return 0;
 }